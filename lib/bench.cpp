@@ -0,0 +1,249 @@
+// Created on February 13 2023
+// By Julen Bernabe Rodriguez <julen.bernabe@tecnalia.com>
+// Copyright (c) 2023 Tecnalia Research & Innovation
+
+/*
+ * Benchmark harness: parameter sweeps, repeated timings and JSON reports
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Parameters swept by a benchmark
+ * 
+ * @param moduli plaintext moduli p
+ * @param ringDimensions ring dimensions (0 lets the planner choose it)
+ * @param batchSizes numbers of slots (0 for as many as the ring offers)
+ * @param threads values of evalThreads
+ * @param streaming values of streamingEvaluation (0 or 1)
+ * @param warmup untimed runs before the timed ones
+ * @param repetitions timed runs of each operation
+ * @param operations operations to be run (all of them if empty)
+ * @param output file of the JSON report ("-" for the standard output)
+ */
+struct BenchConfig {
+    std::vector<unsigned> moduli = {257};
+    std::vector<unsigned> ringDimensions = {0};
+    std::vector<unsigned> batchSizes = {0};
+    std::vector<int> threads = {1};
+    std::vector<int> streaming = {0};
+    unsigned warmup = 1;
+    unsigned repetitions = 5;
+    std::vector<std::string> operations;
+    std::string output = "-";
+};
+
+typedef struct BenchConfig benchConfig;
+
+/*
+ * Splits a comma-separated list.
+ */
+std::vector<std::string> splitList(const std::string &list) {
+    std::vector<std::string> items;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+template <class T>
+std::vector<T> parseList(const std::string &list) {
+    std::vector<T> values;
+    std::vector<std::string> items = splitList(list);
+    for (size_t i = 0; i < items.size(); i++) {
+        std::istringstream item(items[i]);
+        T value;
+        if (item >> value) {
+            values.push_back(value);
+        }
+    }
+    return values;
+}
+
+/**
+ * @brief Read the benchmark parameters from the command line
+ * 
+ * --p 257,65537 --ring 0,16384 --batch 0,1 --threads 1,8 --streaming 0,1 --warmup 1 --reps 5 --ops sign,gt --out bench.json
+ * 
+ * @param argc number of arguments
+ * @param argv arguments
+ * @param config parameters (unchanged for the options that are not given)
+ * @return true if every option was valid
+ */
+bool parseBenchArgs(int argc, char **argv, benchConfig &config) {
+    for (int i = 1; i < argc; i++) {
+        std::string option = argv[i];
+        if (i + 1 >= argc) {
+            return false;
+        }
+        std::string value = argv[++i];
+        if (option == "--p") {
+            config.moduli = parseList<unsigned>(value);
+        } else if (option == "--ring") {
+            config.ringDimensions = parseList<unsigned>(value);
+        } else if (option == "--batch") {
+            config.batchSizes = parseList<unsigned>(value);
+        } else if (option == "--threads") {
+            config.threads = parseList<int>(value);
+        } else if (option == "--streaming") {
+            config.streaming = parseList<int>(value);
+        } else if (option == "--warmup") {
+            config.warmup = std::stoul(value);
+        } else if (option == "--reps") {
+            config.repetitions = std::max(1ul, std::stoul(value));
+        } else if (option == "--ops") {
+            config.operations = splitList(value);
+        } else if (option == "--out") {
+            config.output = value;
+        } else {
+            return false;
+        }
+    }
+    return !config.moduli.empty() && !config.ringDimensions.empty() && !config.batchSizes.empty() && !config.threads.empty() && !config.streaming.empty();
+}
+
+/*
+ * Whether an operation was requested (every operation is, if none was given).
+ */
+bool benchSelected(const benchConfig &config, const std::string &operation) {
+    return config.operations.empty() || std::find(config.operations.begin(), config.operations.end(), operation) != config.operations.end();
+}
+
+/**
+ * @brief Timings of an operation for some parameters
+ * 
+ * @param operation name of the operation
+ * @param parameters parameters of the run (p, ring dimension, batch size, threads...)
+ * @param seconds duration of each timed run
+ */
+struct BenchResult {
+    std::string operation;
+    std::vector<std::pair<std::string, double>> parameters;
+    std::vector<double> seconds;
+};
+
+typedef struct BenchResult benchResult;
+
+/**
+ * @brief Time an operation: warmup untimed runs, then repetitions timed runs
+ * 
+ * @param run the operation
+ * @param warmup number of untimed runs
+ * @param repetitions number of timed runs
+ * @return std::vector<double> duration of each timed run in seconds
+ */
+std::vector<double> timeRepetitions(std::function<void()> run, unsigned warmup, unsigned repetitions) {
+    for (unsigned i = 0; i < warmup; i++) {
+        run();
+    }
+    std::vector<double> seconds;
+    for (unsigned i = 0; i < repetitions; i++) {
+        auto start = std::chrono::steady_clock::now();
+        run();
+        seconds.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+    return seconds;
+}
+
+/*
+ * Escapes a string for JSON.
+ */
+std::string jsonString(const std::string &text) {
+    std::string escaped = "\"";
+    for (size_t i = 0; i < text.size(); i++) {
+        if (text[i] == '"' || text[i] == '\\') {
+            escaped += '\\';
+        }
+        escaped += text[i];
+    }
+    return escaped + "\"";
+}
+
+/*
+ * Collects the results of a benchmark and writes them as JSON, with the summary statistics of each operation.
+ */
+class BenchReport {
+public:
+    BenchReport(std::string name, const benchConfig &config) : name(name), config(config) {}
+
+    void add(const benchResult &result) {
+        results.push_back(result);
+        // Progress goes to the standard error, so the report can be written to the standard output
+        std::cerr << result.operation;
+        for (size_t i = 0; i < result.parameters.size(); i++) {
+            std::cerr << " " << result.parameters[i].first << "=" << result.parameters[i].second;
+        }
+        std::cerr << ": " << median(result.seconds) << " s (median of " << result.seconds.size() << ")" << std::endl;
+    }
+
+    // Writes the report to config.output; false if the file could not be written
+    bool write() const {
+        if (config.output == "-") {
+            writeJson(std::cout);
+            return true;
+        }
+        std::ofstream file(config.output);
+        if (!file.is_open()) {
+            return false;
+        }
+        writeJson(file);
+        return (bool) file;
+    }
+
+private:
+    static double median(std::vector<double> values) {
+        std::sort(values.begin(), values.end());
+        size_t n = values.size();
+        return n % 2 ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2;
+    }
+
+    void writeJson(std::ostream &out) const {
+        out.precision(9);
+        out << "{\n  \"benchmark\": " << jsonString(name) << ",\n";
+        out << "  \"warmup\": " << config.warmup << ",\n";
+        out << "  \"repetitions\": " << config.repetitions << ",\n";
+        out << "  \"results\": [";
+        for (size_t i = 0; i < results.size(); i++) {
+            const benchResult &result = results[i];
+            double mean = 0;
+            for (size_t j = 0; j < result.seconds.size(); j++) {
+                mean += result.seconds[j] / result.seconds.size();
+            }
+            double variance = 0;
+            for (size_t j = 0; j < result.seconds.size(); j++) {
+                variance += (result.seconds[j] - mean) * (result.seconds[j] - mean) / result.seconds.size();
+            }
+            out << (i ? ",\n" : "\n") << "    {\"operation\": " << jsonString(result.operation);
+            for (size_t j = 0; j < result.parameters.size(); j++) {
+                out << ", " << jsonString(result.parameters[j].first) << ": " << result.parameters[j].second;
+            }
+            out << ", \"min\": " << *std::min_element(result.seconds.begin(), result.seconds.end());
+            out << ", \"median\": " << median(result.seconds);
+            out << ", \"mean\": " << mean;
+            out << ", \"stddev\": " << std::sqrt(variance);
+            out << ", \"seconds\": [";
+            for (size_t j = 0; j < result.seconds.size(); j++) {
+                out << (j ? ", " : "") << result.seconds[j];
+            }
+            out << "]}";
+        }
+        out << "\n  ]\n}\n";
+    }
+
+    std::string name;
+    benchConfig config;
+    std::vector<benchResult> results;
+};
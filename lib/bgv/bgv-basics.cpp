@@ -23,18 +23,6 @@ struct crypto {
 };
 
 typedef struct crypto cryptoTools;
-/** 
- * @brief Structure for storing X and Y sets from Step 1
- * 
- * @param x: array containing the elements of X
- * @param fx: array containing the elements of Y (the f(x)'s)
- */
-struct Points {
-    std::vector<int64_t> x;
-    std::vector<int64_t> fx;
-};
-
-typedef struct Points interpolationPoints;
 
 /*
  * Context setup utility methods
@@ -57,15 +45,56 @@ CryptoContext<DCRTPoly> GenerateBGVrnsContext(usint ptm, usint multDepth, usint
     return cc;
 }
 
-cryptoTools genCryptoTools(usint p, usint level) {
+/*
+ * Generates the context of a parameter plan (see planParameters)
+ */
+CryptoContext<DCRTPoly> GeneratePlannedBGVrnsContext(const parameterPlan &plan) {
+    CCParams<CryptoContextBGVRNS> parameters;
+    parameters.SetPlaintextModulus(plan.plaintextModulus);
+    parameters.SetMultiplicativeDepth(plan.depth);
+    parameters.SetSecurityLevel(plan.securityLevel);
+    parameters.SetRingDim(plan.ringDimension);
+    parameters.SetBatchSize(plan.batchSize);
+    parameters.SetNumLargeDigits(plan.numLargeDigits);
+    parameters.SetKeySwitchTechnique(HYBRID);
+    parameters.SetScalingTechnique(FIXEDAUTO);
+
+    CryptoContext<DCRTPoly> cc = GenCryptoContext(parameters);
+    cc->Enable(PKE);
+    cc->Enable(KEYSWITCH);
+    cc->Enable(LEVELEDSHE);
+    cc->Enable(ADVANCEDSHE);
+
+    return cc;
+}
+
+cryptoTools genCryptoTools(const parameterPlan &plan) {
+    cryptoTools cc;
+
+    // Generate context with the planned parameters
+    cc.cryptoContext = GeneratePlannedBGVrnsContext(plan);
+
+    // Key generation
+    cc.keyPair = cc.cryptoContext->KeyGen();
+    cc.cryptoContext->EvalMultKeyGen(cc.keyPair.secretKey);
+    return cc;
+}
+
+/*
+ * Plans the parameters for some operations on values mod p (see planParameters) and generates the context
+ */
+cryptoTools genCryptoTools(usint p, std::vector<PlannedOperation> operations, SecurityLevel securityLevel, usint batchSize, usint limbs = 1,
+                           bool raiseModulus = false) {
+    parameterPlan plan = planParameters(p, operations, securityLevel, batchSize, GeneratePlannedBGVrnsContext, limbs, raiseModulus);
+    printParameterPlan(plan);
+    return genCryptoTools(plan);
+}
+
+cryptoTools genCryptoTools(usint p, usint level, usint depth) {
     cryptoTools cc;
 
-    // compute binary representation of p-1
-    std::vector<uint> binaryRep = binaryRepresentationOfExp(p-1);
-    
     // Define parameters of BGV cryptographic context
     usint ptm                  = p;
-    usint depth                = binaryRep.size() + 1;      // Maximum depth needed is the binary representation of p-1
 
     // Generate context with above parameters
     cc.cryptoContext = GenerateBGVrnsContext(ptm, depth, level);
@@ -76,16 +105,35 @@ cryptoTools genCryptoTools(usint p, usint level) {
     return cc;
 }
 
+cryptoTools genCryptoTools(usint p, usint level) {
+    // Deep enough for every operation, including the plaintext products (see operationDepth)
+    return genCryptoTools(p, level, maxOperationDepth(p));
+}
+
+/*
+ * Encrypts a vector of integers, one per slot. Every operation of the library works slot-wise,
+ * so up to batch-size values are processed at the cost of a single one.
+ */
 Ciphertext<DCRTPoly> encryptV(std::vector<int64_t> v, cryptoTools cc) {
 
     // Encode vector as plaintext
     Plaintext plaintext               = cc.cryptoContext->MakePackedPlaintext(v);
 
     // Encrypt plaintext
-    Ciphertext<DCRTPoly> ciphertext   = cc.cryptoContext->Encrypt(cc.keyPair.publicKey, plaintext);
+    Ciphertext<DCRTPoly> ciphertext   = encryptPlaintext(cc.cryptoContext, cc.keyPair.publicKey, plaintext);
     return ciphertext;
 }
 
+/*
+ * Single-key backend of the evaluation core: fresh ciphertexts are encrypted under the key pair.
+ */
+template <>
+struct KeyBackend<cryptoTools> {
+    static Ciphertext<DCRTPoly> encrypt(std::vector<int64_t> v, const cryptoTools &cc) {
+        return encryptV(v, cc);
+    }
+};
+
 Ciphertext<DCRTPoly> encrypt(int n, cryptoTools cc) {
     // Generate vector with the integer
     std::vector<int64_t> vectorOfInts = {n};
@@ -94,7 +142,7 @@ Ciphertext<DCRTPoly> encrypt(int n, cryptoTools cc) {
     Plaintext plaintext               = cc.cryptoContext->MakePackedPlaintext(vectorOfInts);
 
     // Encrypt plaintext
-    Ciphertext<DCRTPoly> ciphertext   = cc.cryptoContext->Encrypt(cc.keyPair.publicKey, plaintext);
+    Ciphertext<DCRTPoly> ciphertext   = encryptPlaintext(cc.cryptoContext, cc.keyPair.publicKey, plaintext);
     return ciphertext;
 }
 
@@ -0,0 +1,146 @@
+// Created on February 13 2023
+// By Julen Bernabe Rodriguez <julen.bernabe@tecnalia.com>
+// Copyright (c) 2023 Tecnalia Research & Innovation
+
+/*
+ * BGV evaluation client
+ */
+
+#include "scheme/bgvrns/cryptocontext-bgvrns.h"
+#include "gen-cryptocontext.h"
+
+#include <iostream>
+#include <memory>
+#include <vector>
+
+using namespace lbcrypto;
+
+/**
+ * @brief Session with an evaluation server
+ * 
+ * @param fd connected socket
+ * @param buffer buffer of the socket
+ * @param stream stream over the buffer
+ */
+struct EvaluationClient {
+    int fd = -1;
+    std::unique_ptr<SocketStreamBuf> buffer;
+    std::unique_ptr<std::iostream> stream;
+};
+
+typedef struct EvaluationClient evaluationClient;
+
+/**
+ * @brief Connect to an evaluation server and send it the evaluation material (context, public key, evaluation keys)
+ * 
+ * @param client session with the server
+ * @param address address of the server ("unix:<path>" or "<host>:<port>")
+ * @param cc cryptoTools of the client (the secret key never leaves the client)
+ * @return true if the server accepted the session
+ */
+bool connectEvaluationServer(evaluationClient &client, std::string address, cryptoTools cc) {
+    client.fd = connectSocket(address);
+    if (client.fd < 0) {
+        return false;
+    }
+    client.buffer.reset(new SocketStreamBuf(client.fd));
+    client.stream.reset(new std::iostream(client.buffer.get()));
+    std::iostream &stream = *client.stream;
+
+    writeValue<uint32_t>(stream, REQUEST_SETUP);
+    Serial::Serialize(cc.cryptoContext, stream, SerType::BINARY);
+    Serial::Serialize(cc.keyPair.publicKey, stream, SerType::BINARY);
+    cc.cryptoContext->SerializeEvalMultKey(stream, SerType::BINARY, cc.keyPair.secretKey->GetKeyTag());
+    stream.flush();
+
+    uint32_t accepted;
+    return readValue(stream, accepted) && accepted == 1;
+}
+
+/**
+ * @brief Close a session with an evaluation server
+ * 
+ * @param client session with the server
+ */
+void closeEvaluationClient(evaluationClient &client) {
+    if (client.fd < 0) {
+        return;
+    }
+    writeValue<uint32_t>(*client.stream, REQUEST_CLOSE);
+    client.stream->flush();
+    client.stream.reset();
+    client.buffer.reset();
+    close(client.fd);
+    client.fd = -1;
+}
+
+/**
+ * @brief Send a request and wait for its results
+ * 
+ * The inputs are serialized straight into the socket, and the results deserialized straight from it.
+ * 
+ * @param client session with the server
+ * @param type operation requested
+ * @param inputs input ciphertexts
+ * @param expected number of results of the operation (any other count from the server fails the request)
+ * @param divisor clear divisor (REQUEST_PUBLIC_DIVISION)
+ * @return std::vector<Ciphertext<DCRTPoly>> results (empty if the request failed)
+ */
+std::vector<Ciphertext<DCRTPoly>> remoteEvaluation(evaluationClient &client, RequestType type, std::vector<Ciphertext<DCRTPoly>> inputs, uint32_t expected, int64_t divisor = 0) {
+    std::iostream &stream = *client.stream;
+    writeValue<uint32_t>(stream, type);
+    if (type == REQUEST_PUBLIC_DIVISION) {
+        writeValue<int64_t>(stream, divisor);
+    }
+    for (uint i = 0; i < inputs.size(); i++) {
+        writeCiphertext(stream, inputs[i]);
+    }
+    stream.flush();
+
+    std::vector<Ciphertext<DCRTPoly>> results;
+    uint32_t count;
+    if (!readValue(stream, count) || count != expected) {
+        return results;
+    }
+    results.resize(count);
+    for (uint i = 0; i < count; i++) {
+        if (!readCiphertext(stream, results[i])) {
+            results.clear();
+            break;
+        }
+    }
+    return results;
+}
+
+/*
+ * Remote versions of sign, compareAll, intPubDivision and intPrivDivision (nullptr results if the request failed)
+ */
+Ciphertext<DCRTPoly> remoteSign(evaluationClient &client, Ciphertext<DCRTPoly> c) {
+    std::vector<Ciphertext<DCRTPoly>> results = remoteEvaluation(client, REQUEST_SIGN, {c}, 1);
+    return results.size() == 1 ? results[0] : nullptr;
+}
+
+comparisonResults remoteCompareAll(evaluationClient &client, Ciphertext<DCRTPoly> c1, Ciphertext<DCRTPoly> c2) {
+    std::vector<Ciphertext<DCRTPoly>> results = remoteEvaluation(client, REQUEST_COMPARE, {c1, c2}, 7);
+    comparisonResults comparisons;
+    if (results.size() == 7) {
+        comparisons.eq = results[0];
+        comparisons.gt = results[1];
+        comparisons.gteq = results[2];
+        comparisons.lt = results[3];
+        comparisons.lteq = results[4];
+        comparisons.max = results[5];
+        comparisons.min = results[6];
+    }
+    return comparisons;
+}
+
+Ciphertext<DCRTPoly> remotePublicDivision(evaluationClient &client, Ciphertext<DCRTPoly> dividend, int64_t divisor) {
+    std::vector<Ciphertext<DCRTPoly>> results = remoteEvaluation(client, REQUEST_PUBLIC_DIVISION, {dividend}, 1, divisor);
+    return results.size() == 1 ? results[0] : nullptr;
+}
+
+Ciphertext<DCRTPoly> remotePrivateDivision(evaluationClient &client, Ciphertext<DCRTPoly> dividend, Ciphertext<DCRTPoly> divisor) {
+    std::vector<Ciphertext<DCRTPoly>> results = remoteEvaluation(client, REQUEST_PRIVATE_DIVISION, {dividend, divisor}, 1);
+    return results.size() == 1 ? results[0] : nullptr;
+}
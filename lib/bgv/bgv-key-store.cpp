@@ -0,0 +1,89 @@
+// Created on February 13 2023
+// By Julen Bernabe Rodriguez <julen.bernabe@tecnalia.com>
+// Copyright (c) 2023 Tecnalia Research & Innovation
+
+/*
+ * BGV key store
+ */
+
+#include "scheme/bgvrns/cryptocontext-bgvrns.h"
+#include "gen-cryptocontext.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+
+using namespace lbcrypto;
+
+/**
+ * @brief Store cryptoTools (context, key pair and evaluation keys)
+ * 
+ * @param cc cryptoTools to be stored
+ * @param plan parameters cc was generated for
+ * @param path file of the store
+ * @return true if the store was written
+ */
+bool saveCryptoTools(const cryptoTools &cc, const parameterPlan &plan, std::string path) {
+    std::vector<keyStoreSection> sections;
+    sections.push_back(serializedSection("context", cc.cryptoContext));
+    sections.push_back(serializedSection("public-key", cc.keyPair.publicKey));
+    sections.push_back(serializedSection("secret-key", cc.keyPair.secretKey));
+    std::ostringstream evalMultKeys;
+    cc.cryptoContext->SerializeEvalMultKey(evalMultKeys, SerType::BINARY);
+    sections.push_back({"eval-mult-keys", evalMultKeys.str()});
+    return writeKeyStore(path, plan, sections);
+}
+
+/**
+ * @brief Load cryptoTools from a store
+ * 
+ * @param cc loaded cryptoTools (unchanged if false is returned)
+ * @param plan parameters the keys must have been generated for
+ * @param path file of the store
+ * @return true if the store exists, is complete and was generated for plan
+ */
+bool loadCryptoTools(cryptoTools &cc, const parameterPlan &plan, std::string path) {
+    KeyStore store;
+    if (!openKeyStore(path, store) || !samePlan(store.plan, plan)) {
+        return false;
+    }
+    cryptoTools loaded;
+    // The evaluation keys refer to the context, so they are loaded after it
+    bool complete = readSerializedSection(store, "context", loaded.cryptoContext) &&
+                    readSerializedSection(store, "public-key", loaded.keyPair.publicKey) &&
+                    readSerializedSection(store, "secret-key", loaded.keyPair.secretKey) &&
+                    readSection(store, "eval-mult-keys", [&](std::istream &stream) {
+                        loaded.cryptoContext->DeserializeEvalMultKey(stream, SerType::BINARY);
+                    });
+    if (!complete) {
+        return false;
+    }
+    cc = loaded;
+    return true;
+}
+
+/**
+ * @brief Load cryptoTools from a store, or generate (and store) them if there is no valid store
+ * 
+ * Generating the keys takes tens of seconds with secure parameters, loading them only milliseconds.
+ * 
+ * @param path file of the store
+ * @param p plaintext modulus (see planParameters)
+ * @param operations operations to be run
+ * @param securityLevel security level
+ * @param batchSize number of slots needed (0 for as many as the ring offers)
+ * @param limbs number of limbs of the multi-limb integers (PLAN_MULTI_LIMB)
+ * @param raiseModulus whether p may be raised to support packing in the secure ring (see planParameters)
+ * @return cryptoTools (cryptographical context + keys)
+ */
+cryptoTools loadOrGenCryptoTools(std::string path, usint p, std::vector<PlannedOperation> operations, SecurityLevel securityLevel, usint batchSize, usint limbs = 1,
+                                 bool raiseModulus = false) {
+    parameterPlan plan = planParameters(p, operations, securityLevel, batchSize, GeneratePlannedBGVrnsContext, limbs, raiseModulus);
+    printParameterPlan(plan);
+    cryptoTools cc;
+    if (!loadCryptoTools(cc, plan, path)) {
+        cc = genCryptoTools(plan);
+        saveCryptoTools(cc, plan, path);
+    }
+    return cc;
+}
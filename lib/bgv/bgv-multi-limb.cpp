@@ -0,0 +1,33 @@
+// Created on February 13 2023
+// By Julen Bernabe Rodriguez <julen.bernabe@tecnalia.com>
+// Copyright (c) 2023 Tecnalia Research & Innovation
+
+/*
+ * BGV multi-limb integers
+ */
+
+#include "scheme/bgvrns/cryptocontext-bgvrns.h"
+#include "gen-cryptocontext.h"
+
+#include <iostream>
+#include <fstream>
+#include <limits>
+#include <iterator>
+#include <random>
+
+using namespace lbcrypto;
+
+/**
+ * @brief Decrypt the limbs of an encrypted integer and recompose the integer
+ * 
+ * @param c encrypted integer
+ * @param cc cryptographical context
+ * @return uint64_t the decrypted integer
+ */
+uint64_t decryptInteger(encryptedInteger c, cryptoTools cc) {
+    std::vector<int64_t> limbs;
+    for (uint i = 0; i < c.limbs.size(); i++) {
+        limbs.push_back(decrypt(c.limbs[i], cc)[0]);
+    }
+    return fromLimbs(limbs, c.base);
+}
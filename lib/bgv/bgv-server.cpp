@@ -0,0 +1,423 @@
+// Created on February 13 2023
+// By Julen Bernabe Rodriguez <julen.bernabe@tecnalia.com>
+// Copyright (c) 2023 Tecnalia Research & Innovation
+
+/*
+ * BGV evaluation server
+ */
+
+#include "scheme/bgvrns/cryptocontext-bgvrns.h"
+#include "gen-cryptocontext.h"
+
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <future>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+#include <map>
+
+using namespace lbcrypto;
+
+/**
+ * @brief Evaluation request of a client
+ * 
+ * @param type operation requested
+ * @param inputs input ciphertexts
+ * @param divisor clear divisor (REQUEST_PUBLIC_DIVISION)
+ */
+struct EvaluationRequest {
+    RequestType type;
+    std::vector<Ciphertext<DCRTPoly>> inputs;
+    int64_t divisor = 0;
+};
+
+typedef struct EvaluationRequest evaluationRequest;
+
+/*
+ * Evaluation keys of a client, by key tag (as serialized by SerializeEvalMultKey).
+ */
+typedef std::map<std::string, std::vector<EvalKey<DCRTPoly>>> evalMultKeyMap;
+
+/**
+ * @brief Read the evaluation material of a client: context, public key and evaluation keys (never its secret key)
+ * 
+ * The evaluation keys are only read here: they are installed in OpenFHE's static key map by installSetup.
+ * 
+ * @param stream stream of the client
+ * @param cc cryptoTools containing the context and public key of the client
+ * @param evalMultKeys evaluation keys of the client
+ * @return true if the material could be read
+ */
+bool readSetup(std::istream &stream, cryptoTools &cc, evalMultKeyMap &evalMultKeys) {
+    try {
+        Serial::Deserialize(cc.cryptoContext, stream, SerType::BINARY);
+        Serial::Deserialize(cc.keyPair.publicKey, stream, SerType::BINARY);
+        Serial::Deserialize(evalMultKeys, stream, SerType::BINARY);
+    } catch (const std::exception &e) {
+        return false;
+    }
+    return !stream.fail();
+}
+
+/**
+ * @brief Read the inputs of a request
+ * 
+ * @param stream stream of the client
+ * @param type operation requested
+ * @param request request containing the inputs
+ * @return true if the operation is known and its inputs could be read
+ */
+bool readRequest(std::istream &stream, RequestType type, evaluationRequest &request) {
+    request.type = type;
+    uint inputs;
+    switch (type) {
+        case REQUEST_SIGN:
+            inputs = 1;
+            break;
+        case REQUEST_COMPARE:
+        case REQUEST_PRIVATE_DIVISION:
+            inputs = 2;
+            break;
+        case REQUEST_PUBLIC_DIVISION:
+            inputs = 1;
+            if (!readValue(stream, request.divisor)) {
+                return false;
+            }
+            break;
+        default:
+            return false;
+    }
+    request.inputs.resize(inputs);
+    for (uint i = 0; i < inputs; i++) {
+        if (!readCiphertext(stream, request.inputs[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Evaluate a request
+ * 
+ * @param request request read by readRequest
+ * @param cc cryptoTools of the client
+ * @return std::vector<Ciphertext<DCRTPoly>> results, switched down to the smallest modulus (empty if the evaluation failed)
+ */
+std::vector<Ciphertext<DCRTPoly>> evaluateRequest(const evaluationRequest &request, cryptoTools cc) {
+    std::vector<Ciphertext<DCRTPoly>> results;
+    try {
+        switch (request.type) {
+            case REQUEST_SIGN:
+                results.push_back(sign(request.inputs[0], cc));
+                break;
+            case REQUEST_COMPARE: {
+                comparisonResults comparisons = compareAll(request.inputs[0], request.inputs[1], cc);
+                results = {comparisons.eq, comparisons.gt, comparisons.gteq, comparisons.lt, comparisons.lteq, comparisons.max, comparisons.min};
+                break;
+            }
+            case REQUEST_PUBLIC_DIVISION:
+                results.push_back(intPubDivision(request.inputs[0], request.divisor, cc));
+                break;
+            case REQUEST_PRIVATE_DIVISION:
+                results.push_back(intPrivDivision(request.inputs[0], request.inputs[1], cc));
+                break;
+            default:
+                break;
+        }
+        for (uint i = 0; i < results.size(); i++) {
+            results[i] = compactCiphertext(results[i], cc.cryptoContext);
+        }
+    } catch (const std::exception &e) {
+        // e.g. ciphertexts of another context: the client gets no results, the server keeps serving
+        results.clear();
+    }
+    return results;
+}
+
+/**
+ * @brief Bytes a request is expected to hold while it is evaluated
+ * 
+ * The peak measured for its operation in the previous requests, or before the first one, the p-1 powers
+ * of each input at its size.
+ * 
+ * @param request request read by readRequest
+ * @param cc cryptoTools of the client
+ * @return uint64_t expected peak bytes
+ */
+uint64_t expectedRequestBytes(const evaluationRequest &request, cryptoTools cc) {
+    uint64_t p = cc.cryptoContext->GetCryptoParameters()->GetPlaintextModulus();
+    uint64_t fallback = (p - 1) * request.inputs.size() * ciphertextBytes(request.inputs[0]);
+    switch (request.type) {
+        case REQUEST_SIGN:
+            return expectedPeakBytes("sign", fallback);
+        case REQUEST_COMPARE:
+            return expectedPeakBytes("compareAll", fallback);
+        case REQUEST_PUBLIC_DIVISION:
+            return expectedPeakBytes("intPubDivision", fallback);
+        case REQUEST_PRIVATE_DIVISION:
+            return expectedPeakBytes("intPrivDivision", fallback);
+        default:
+            return fallback;
+    }
+}
+
+/*
+ * Writes the answer to a request: the number of results followed by the results.
+ */
+void writeResults(std::ostream &stream, const std::vector<Ciphertext<DCRTPoly>> &results) {
+    writeValue<uint32_t>(stream, results.size());
+    for (uint i = 0; i < results.size(); i++) {
+        writeCiphertext(stream, results[i]);
+    }
+    stream.flush();
+}
+
+/**
+ * @brief Evaluation job: a request of a client and the promise of its results
+ * 
+ * @param request request read from the client
+ * @param cc cryptoTools of the client
+ * @param results results of the evaluation, fulfilled by a worker
+ */
+struct EvaluationJob {
+    evaluationRequest request;
+    cryptoTools cc;
+    std::promise<std::vector<Ciphertext<DCRTPoly>>> results;
+};
+
+/**
+ * @brief Answer to a client, written in the order of its requests
+ * 
+ * @param setup true for the answer to REQUEST_SETUP
+ * @param accepted whether the setup was accepted
+ * @param results results of an evaluation request
+ */
+struct PendingAnswer {
+    bool setup = false;
+    bool accepted = false;
+    std::shared_future<std::vector<Ciphertext<DCRTPoly>>> results;
+};
+
+/**
+ * @brief Evaluation daemon: a pool of workers evaluating the requests of every client
+ * 
+ * The evaluation keys of a client (and the encoded interpolation plans of its context) stay loaded while some
+ * session uses them, and are released when the last one ends. Backpressure
+ * works at two levels: a connection stops reading requests while the job queue is full, and also while
+ * its client has pendingPerClient answers that it has not read yet.
+ * 
+ * OpenFHE keeps the evaluation keys of every context in a static map, so installing the keys of a new client
+ * waits for the running evaluations, and evaluations wait for the installation.
+ * 
+ * @param jobs jobs waiting for a worker
+ * @param workers worker threads
+ * @param pendingPerClient answers of a client that may be in flight
+ * @param keysMutex mutex guarding evaluating and installing
+ * @param keysIdle signalled when evaluating or installing change
+ * @param evaluating number of running evaluations
+ * @param installing whether the keys of a client are being installed
+ * @param sessionsPerKey sessions using the evaluation keys of each key tag
+ */
+struct EvaluationDaemon {
+    BoundedQueue<std::shared_ptr<EvaluationJob>> jobs;
+    std::vector<std::thread> workers;
+    uint pendingPerClient;
+    std::mutex keysMutex;
+    std::condition_variable keysIdle;
+    uint evaluating = 0;
+    bool installing = false;
+    std::map<std::string, uint> sessionsPerKey;
+
+    EvaluationDaemon(uint queueSize, uint pendingPerClient) : jobs(queueSize), pendingPerClient(pendingPerClient) {}
+};
+
+/*
+ * Evaluates jobs until the job queue is closed. A job starts once its expected memory fits in the memory budget.
+ */
+void runWorker(EvaluationDaemon &daemon, int threads) {
+#ifdef _OPENMP
+    // The workers share the cores: each one gets its share for the OpenFHE loops of its jobs
+    omp_set_num_threads(threads);
+#endif
+    std::shared_ptr<EvaluationJob> job;
+    while (daemon.jobs.pop(job)) {
+        std::vector<Ciphertext<DCRTPoly>> results;
+        {
+            MemoryReservation reservation(expectedRequestBytes(job->request, job->cc));
+            {
+                std::unique_lock<std::mutex> lock(daemon.keysMutex);
+                daemon.keysIdle.wait(lock, [&daemon] { return !daemon.installing; });
+                daemon.evaluating++;
+            }
+            results = evaluateRequest(job->request, job->cc);
+            {
+                std::lock_guard<std::mutex> lock(daemon.keysMutex);
+                daemon.evaluating--;
+            }
+            daemon.keysIdle.notify_all();
+        }
+        job->results.set_value(results);
+        job.reset();
+    }
+}
+
+/*
+ * Waits until no evaluation is running and closes the gate of the evaluations.
+ */
+void lockKeys(EvaluationDaemon &daemon) {
+    std::unique_lock<std::mutex> lock(daemon.keysMutex);
+    daemon.keysIdle.wait(lock, [&daemon] { return !daemon.installing && daemon.evaluating == 0; });
+    daemon.installing = true;
+}
+
+/*
+ * Opens the gate of the evaluations again.
+ */
+void unlockKeys(EvaluationDaemon &daemon) {
+    {
+        std::lock_guard<std::mutex> lock(daemon.keysMutex);
+        daemon.installing = false;
+    }
+    daemon.keysIdle.notify_all();
+}
+
+/*
+ * Reads the evaluation material of a client, then installs its evaluation keys while no evaluation is running.
+ * The material is read before taking the gate, so a slow client never stalls the evaluations of the others.
+ * The tags of the installed keys are added to keyTags (see releaseSetup).
+ */
+bool installSetup(EvaluationDaemon &daemon, std::istream &stream, cryptoTools &cc, std::vector<std::string> &keyTags) {
+    cryptoTools received;
+    evalMultKeyMap evalMultKeys;
+    if (!readSetup(stream, received, evalMultKeys)) {
+        return false;
+    }
+    lockKeys(daemon);
+    bool ready = true;
+    for (auto &keys : evalMultKeys) {
+        try {
+            CryptoContextImpl<DCRTPoly>::InsertEvalMultKey(keys.second);
+        } catch (const std::exception &e) {
+            ready = false;
+            continue;
+        }
+        // Reinstalling the keys of a tag in use replaces them by the same keys, so only the count changes
+        daemon.sessionsPerKey[keys.first]++;
+        keyTags.push_back(keys.first);
+    }
+    unlockKeys(daemon);
+    if (ready) {
+        cc = received;
+    }
+    return ready;
+}
+
+/*
+ * Releases the evaluation keys installed by a session once it has no evaluation left: the keys of a tag no other
+ * session uses are removed from OpenFHE's static map, and the encoded plans of the context are dropped with them.
+ */
+void releaseSetup(EvaluationDaemon &daemon, const std::vector<std::string> &keyTags, const cryptoTools &cc) {
+    if (keyTags.empty()) {
+        return;
+    }
+    lockKeys(daemon);
+    bool released = false;
+    for (uint i = 0; i < keyTags.size(); i++) {
+        if (--daemon.sessionsPerKey[keyTags[i]] == 0) {
+            daemon.sessionsPerKey.erase(keyTags[i]);
+            CryptoContextImpl<DCRTPoly>::ClearEvalMultKeys(keyTags[i]);
+            released = true;
+        }
+    }
+    unlockKeys(daemon);
+    if (released && cc.cryptoContext) {
+        dropInterpolationPlans(cc);
+    }
+}
+
+/**
+ * @brief Start the workers of the daemon
+ * 
+ * @param daemon evaluation daemon
+ * @param workers number of workers (the cores are split evenly among them)
+ */
+void startWorkers(EvaluationDaemon &daemon, uint workers) {
+    uint cores = std::max(1u, std::thread::hardware_concurrency());
+    int threads = std::max(1u, cores / std::max(1u, workers));
+    for (uint i = 0; i < workers; i++) {
+        daemon.workers.push_back(std::thread(runWorker, std::ref(daemon), threads));
+    }
+}
+
+/**
+ * @brief Stop the workers of the daemon once the queued jobs are evaluated
+ * 
+ * @param daemon evaluation daemon
+ */
+void stopWorkers(EvaluationDaemon &daemon) {
+    daemon.jobs.close();
+    for (uint i = 0; i < daemon.workers.size(); i++) {
+        daemon.workers[i].join();
+    }
+    daemon.workers.clear();
+}
+
+/**
+ * @brief Serve the requests of a client until it closes the session (or sends a malformed request)
+ * 
+ * The requests are read and queued as they arrive, and a writer thread sends the answers in the order of
+ * the requests, so a client may pipeline several requests.
+ * 
+ * @param daemon evaluation daemon
+ * @param fd connected socket of the client
+ */
+void serveClient(EvaluationDaemon &daemon, int fd) {
+    SocketStreamBuf buffer(fd);
+    std::istream input(&buffer);
+    std::ostream output(&buffer);
+
+    BoundedQueue<PendingAnswer> pending(daemon.pendingPerClient);
+    std::thread writer([&] {
+        PendingAnswer answer;
+        while (pending.pop(answer)) {
+            if (answer.setup) {
+                writeValue<uint32_t>(output, answer.accepted ? 1 : 0);
+                output.flush();
+            } else {
+                writeResults(output, answer.results.get());
+            }
+        }
+    });
+
+    cryptoTools cc;
+    std::vector<std::string> keyTags;
+    bool ready = false;
+    uint32_t type;
+    while (readValue(input, type) && type != REQUEST_CLOSE) {
+        PendingAnswer answer;
+        if (type == REQUEST_SETUP) {
+            ready = installSetup(daemon, input, cc, keyTags);
+            answer.setup = true;
+            answer.accepted = ready;
+            pending.push(answer);
+            continue;
+        }
+        std::shared_ptr<EvaluationJob> job = std::make_shared<EvaluationJob>();
+        answer.results = job->results.get_future().share();
+        bool valid = ready && readRequest(input, (RequestType) type, job->request);
+        job->cc = cc;
+        pending.push(answer);
+        if (!valid || !daemon.jobs.push(job)) {
+            // Malformed request (or daemon stopping): answer with no results and end the session
+            job->results.set_value({});
+            break;
+        }
+    }
+    pending.close();
+    writer.join();
+    // Every answer has been written, so no job of this session is left
+    releaseSetup(daemon, keyTags, cc);
+}
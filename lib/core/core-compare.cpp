@@ -0,0 +1,400 @@
+// Created on February 13 2023
+// By Julen Bernabe Rodriguez <julen.bernabe@tecnalia.com>
+// Copyright (c) 2023 Tecnalia Research & Innovation
+
+/*
+ * Evaluation core: comparisons
+ */
+
+#include "scheme/bgvrns/cryptocontext-bgvrns.h"
+#include "gen-cryptocontext.h"
+
+#include <iostream>
+#include <fstream>
+#include <limits>
+#include <iterator>
+#include <random>
+#include <time.h>
+
+using namespace lbcrypto;
+
+
+interpolationPoints evalSignPoints(int p) {
+    interpolationPoints ip;
+    ip.x.push_back(0);
+    ip.fx.push_back(0);
+    for (int i = 1; i < p; i++) {
+        if (i <= (p-1)/2) {
+            ip.x.push_back(i);
+            ip.fx.push_back(1);
+        } else {
+            ip.x.push_back(-(p-i));
+            ip.fx.push_back(-1);
+        }  
+    }
+    return ip;
+}
+
+interpolationPoints evalEqualPoints(int p) {
+    interpolationPoints ip;
+    ip.x.push_back(0);
+    ip.fx.push_back(1);
+    for (int i = 1; i < p; i++) {
+        if (i <= (p-1)/2) {
+            ip.x.push_back(i);
+            ip.fx.push_back(0);
+        } else if (i > (p-1)/2) {
+            ip.x.push_back(-(p-i));
+            ip.fx.push_back(0);
+        }
+    }
+    return ip;
+}
+
+interpolationPoints evalGreaterPoints(int p) {
+    interpolationPoints ip;
+    ip.x.push_back(0);
+    ip.fx.push_back(0);
+    for (int i = 1; i < p; i++) {
+        if (i <= (p-1)/2) {
+            ip.x.push_back(i);
+            ip.fx.push_back(1);
+        } else {
+            ip.x.push_back(-(p-i));
+            ip.fx.push_back(0);
+        }  
+    }
+    return ip;
+}
+
+interpolationPoints evalGreaterEqualPoints(int p) {
+    interpolationPoints ip;
+    ip.x.push_back(0);
+    ip.fx.push_back(1);
+    for (int i = 1; i < p; i++) {
+        if (i <= (p-1)/2) {
+            ip.x.push_back(i);
+            ip.fx.push_back(1);
+        } else {
+            ip.x.push_back(-(p-i));
+            ip.fx.push_back(0);
+        }  
+    }
+    return ip;
+}
+
+interpolationPoints evalLowerPoints(int p) {
+    interpolationPoints ip;
+    ip.x.push_back(0);
+    ip.fx.push_back(0);
+    for (int i = 1; i < p; i++) {
+        if (i <= (p-1)/2) {
+            ip.x.push_back(i);
+            ip.fx.push_back(0);
+        } else {
+            ip.x.push_back(-(p-i));
+            ip.fx.push_back(1);
+        }  
+    }
+    return ip;
+}
+
+interpolationPoints evalLowerEqualPoints(int p) {
+    interpolationPoints ip;
+    ip.x.push_back(0);
+    ip.fx.push_back(1);
+    for (int i = 1; i < p; i++) {
+        if (i <= (p-1)/2) {
+            ip.x.push_back(i);
+            ip.fx.push_back(0);
+        } else {
+            ip.x.push_back(-(p-i));
+            ip.fx.push_back(1);
+        }  
+    }
+    return ip;
+}
+
+template <class Tools>
+Ciphertext<DCRTPoly> sign(Ciphertext<DCRTPoly> c, Tools cc) {
+    CountedOperation counted("sign", {c});
+    interpolationPlan plan = getInterpolationPlan("sign", evalSignPoints, cc);
+    Ciphertext<DCRTPoly> evaluation = evalPolynomial(c, plan, cc);
+    return counted.output(evaluation);
+}
+
+/**
+ * @brief Compute c == 0 from the power ladder of c
+ * 
+ * By Fermat's little theorem c^{p-1} is 1 for every c != 0, so c == 0 is 1 - c^{p-1}: about log2(p)
+ * multiplications (fewer if the ladder already contains the powers of two of c) instead of interpolating.
+ * 
+ * @param ladder power ladder of c (c^{p-1} and the powers it needs are added to it)
+ * @param cc cryptographical context
+ * @return Ciphertext<DCRTPoly> containing 1 if c == 0 and 0 otherwise
+ */
+template <class Tools>
+Ciphertext<DCRTPoly> equalZero(powerLadder &ladder, Tools cc) {
+    int p = cc.cryptoContext->GetCryptoParameters()->GetPlaintextModulus();
+    Ciphertext<DCRTPoly> fermat = getPower(ladder, p - 1, cc);
+    Ciphertext<DCRTPoly> evaluation = evalAdd(cc.cryptoContext, evalNegate(cc.cryptoContext, fermat), encodeCoefficient(1, cc));
+    return evaluation;
+}
+
+template <class Tools>
+Ciphertext<DCRTPoly> equalZero(Ciphertext<DCRTPoly> c, Tools cc) {
+    CountedOperation counted("equalZero", {c});
+    powerLadder ladder = initPowerLadder(c);
+    return counted.output(equalZero(ladder, cc));
+}
+
+template <class Tools>
+Ciphertext<DCRTPoly> greaterThanZero(Ciphertext<DCRTPoly> c, Tools cc) {
+    CountedOperation counted("greaterThanZero", {c});
+    interpolationPlan plan = getInterpolationPlan("greater", evalGreaterPoints, cc);
+    Ciphertext<DCRTPoly> evaluation = evalPolynomial(c, plan, cc);
+    return counted.output(evaluation);
+}
+
+template <class Tools>
+Ciphertext<DCRTPoly> greaterEqualThanZero(Ciphertext<DCRTPoly> c, Tools cc) {
+    CountedOperation counted("greaterEqualThanZero", {c});
+    interpolationPlan plan = getInterpolationPlan("greaterEqual", evalGreaterEqualPoints, cc);
+    Ciphertext<DCRTPoly> evaluation = evalPolynomial(c, plan, cc);
+    return counted.output(evaluation);
+}
+
+template <class Tools>
+Ciphertext<DCRTPoly> lowerThanZero(Ciphertext<DCRTPoly> c, Tools cc) {
+    CountedOperation counted("lowerThanZero", {c});
+    interpolationPlan plan = getInterpolationPlan("lower", evalLowerPoints, cc);
+    Ciphertext<DCRTPoly> evaluation = evalPolynomial(c, plan, cc);
+    return counted.output(evaluation);
+}
+
+template <class Tools>
+Ciphertext<DCRTPoly> lowerEqualThanZero(Ciphertext<DCRTPoly> c, Tools cc) {
+    CountedOperation counted("lowerEqualThanZero", {c});
+    interpolationPlan plan = getInterpolationPlan("lowerEqual", evalLowerEqualPoints, cc);
+    Ciphertext<DCRTPoly> evaluation = evalPolynomial(c, plan, cc);
+    return counted.output(evaluation);
+}
+
+template <class Tools>
+Ciphertext<DCRTPoly> equal(Ciphertext<DCRTPoly> c1, Ciphertext<DCRTPoly> c2, Tools cc) {
+    CountedOperation counted("equal", {c1, c2});
+    // Compute difference = c1 - c2
+    Ciphertext<DCRTPoly> difference = evalSub(cc.cryptoContext, c1, c2);
+    
+    Ciphertext<DCRTPoly> result = equalZero(difference, cc);
+
+    return counted.output(result);
+}
+
+template <class Tools>
+Ciphertext<DCRTPoly> gt(Ciphertext<DCRTPoly> c1, Ciphertext<DCRTPoly> c2, Tools cc) {
+    CountedOperation counted("gt", {c1, c2});
+    // Compute the difference
+    Ciphertext<DCRTPoly> difference = evalSub(cc.cryptoContext, c1, c2);
+
+    // Check if it is greater than 0 or not
+    Ciphertext<DCRTPoly> result = greaterThanZero(difference, cc);
+
+    return counted.output(result);
+}
+
+template <class Tools>
+Ciphertext<DCRTPoly> gteq(Ciphertext<DCRTPoly> c1, Ciphertext<DCRTPoly> c2, Tools cc) {
+    CountedOperation counted("gteq", {c1, c2});
+    // Compute the difference
+    Ciphertext<DCRTPoly> difference = evalSub(cc.cryptoContext, c1, c2);
+
+    // Check if it is greater than 0 or not
+    Ciphertext<DCRTPoly> result = greaterEqualThanZero(difference, cc);
+
+    return counted.output(result);
+}
+
+template <class Tools>
+Ciphertext<DCRTPoly> lt(Ciphertext<DCRTPoly> c1, Ciphertext<DCRTPoly> c2, Tools cc) {
+    CountedOperation counted("lt", {c1, c2});
+    // Compute the difference
+    Ciphertext<DCRTPoly> difference = evalSub(cc.cryptoContext, c1, c2);
+
+    // Check if it is greater than 0 or not
+    Ciphertext<DCRTPoly> result = lowerThanZero(difference, cc);
+
+    return counted.output(result);
+}
+
+template <class Tools>
+Ciphertext<DCRTPoly> lteq(Ciphertext<DCRTPoly> c1, Ciphertext<DCRTPoly> c2, Tools cc) {
+    CountedOperation counted("lteq", {c1, c2});
+    // Compute the difference
+    Ciphertext<DCRTPoly> difference = evalSub(cc.cryptoContext, c1, c2);
+
+    // Check if it is greater than 0 or not
+    Ciphertext<DCRTPoly> result = lowerEqualThanZero(difference, cc);
+
+    return counted.output(result);
+}
+
+template <class Tools>
+Ciphertext<DCRTPoly> max(Ciphertext<DCRTPoly> c1, Ciphertext<DCRTPoly> c2, Tools cc) {
+    CountedOperation counted("max", {c1, c2});
+    // Compute d1 = c1 - c2
+    Ciphertext<DCRTPoly> d1 = evalSub(cc.cryptoContext, c1, c2);
+
+    // Check if d1 is greater than 0 or not
+    Ciphertext<DCRTPoly> g1 = greaterEqualThanZero(d1, cc);
+
+    // Compute d2 = c2 - c1
+    Ciphertext<DCRTPoly> d2 = evalSub(cc.cryptoContext, c2, c1);
+
+    // Check if d2 is greater than 0 or not
+    Ciphertext<DCRTPoly> g2 = greaterThanZero(d2, cc);
+
+    // Formula = g1 x c1 + g2 x c2 (relinearized once, after the addition)
+    Ciphertext<DCRTPoly> r1 = evalMultNoRelin(cc.cryptoContext, g1, c1);
+    Ciphertext<DCRTPoly> r2 = evalMultNoRelin(cc.cryptoContext, g2, c2);
+    Ciphertext<DCRTPoly> result = relinearize(cc.cryptoContext, evalAdd(cc.cryptoContext, r1, r2));
+    return counted.output(result);
+}
+
+template <class Tools>
+Ciphertext<DCRTPoly> min(Ciphertext<DCRTPoly> c1, Ciphertext<DCRTPoly> c2, Tools cc) {
+    CountedOperation counted("min", {c1, c2});
+    // Compute d1 = c1 - c2
+    Ciphertext<DCRTPoly> d1 = evalSub(cc.cryptoContext, c1, c2);
+
+    // Check if d1 is greater than 0 or not
+    Ciphertext<DCRTPoly> g1 = lowerEqualThanZero(d1, cc);
+
+    // Compute d2 = c2 - c1
+    Ciphertext<DCRTPoly> d2 = evalSub(cc.cryptoContext, c2, c1);
+
+    // Check if d2 is greater than 0 or not
+    Ciphertext<DCRTPoly> g2 = lowerThanZero(d2, cc);
+
+    // Formula = g1 x c1 + g2 x c2 (relinearized once, after the addition)
+    Ciphertext<DCRTPoly> r1 = evalMultNoRelin(cc.cryptoContext, g1, c1);
+    Ciphertext<DCRTPoly> r2 = evalMultNoRelin(cc.cryptoContext, g2, c2);
+    Ciphertext<DCRTPoly> result = relinearize(cc.cryptoContext, evalAdd(cc.cryptoContext, r1, r2));
+    return counted.output(result);
+}
+
+/**
+ * @brief Encrypted results of every comparison between c1 and c2
+ * 
+ * @param eq c1 == c2
+ * @param gt c1 > c2
+ * @param gteq c1 >= c2
+ * @param lt c1 < c2
+ * @param lteq c1 <= c2
+ * @param max max(c1, c2)
+ * @param min min(c1, c2)
+ */
+struct Comparisons {
+    Ciphertext<DCRTPoly> eq;
+    Ciphertext<DCRTPoly> gt;
+    Ciphertext<DCRTPoly> gteq;
+    Ciphertext<DCRTPoly> lt;
+    Ciphertext<DCRTPoly> lteq;
+    Ciphertext<DCRTPoly> max;
+    Ciphertext<DCRTPoly> min;
+};
+
+typedef struct Comparisons comparisonResults;
+
+/**
+ * @brief Compute every comparison between c1 and c2 from the sign and equality polynomials of c1 - c2
+ * 
+ * The powers of the difference are computed once. The remaining predicates follow from:
+ * gt = (sign + 1 - eq) / 2, gteq = gt + eq, lteq = 1 - gt, lt = 1 - gt - eq,
+ * max = c2 + gt x (c1 - c2) and min = c1 - gt x (c1 - c2).
+ * Every operation is a node of a task graph, so the powers needed by eq are computed while sign is evaluated,
+ * and the seven results run concurrently with evalThreads > 1.
+ * With streamingEvaluation a single stream of the powers of the difference evaluates sign and eq instead.
+ * 
+ * @param c1 first ciphertext
+ * @param c2 second ciphertext
+ * @param cc cryptographical context
+ * @return comparisonResults containing every comparison
+ */
+template <class Tools>
+comparisonResults compareAll(Ciphertext<DCRTPoly> c1, Ciphertext<DCRTPoly> c2, Tools cc) {
+    CountedOperation counted("compareAll", {c1, c2});
+    int p = cc.cryptoContext->GetCryptoParameters()->GetPlaintextModulus();
+    CryptoContext<DCRTPoly> context = cc.cryptoContext;
+    Plaintext one = encodeCoefficient(1, cc);
+    Plaintext half = encodeCoefficient((p + 1) / 2, cc);
+    if (streamingEvaluation) {
+        // One stream of the powers of the difference feeds both sign and eq, then the same identities as below
+        Ciphertext<DCRTPoly> difference = evalSub(context, c1, c2);
+        std::vector<Ciphertext<DCRTPoly>> evaluations = evalPolynomialsStreaming(difference, {
+            getInterpolationPlan("sign", evalSignPoints, cc), getInterpolationPlan("equal", evalEqualPoints, cc)
+        }, cc);
+        Ciphertext<DCRTPoly> eq = evaluations[1];
+        Ciphertext<DCRTPoly> gt = evalMult(context, evalAdd(context, evalSub(context, evaluations[0], eq), one), half);
+        Ciphertext<DCRTPoly> lteq = evalAdd(context, evalNegate(context, gt), one);
+        Ciphertext<DCRTPoly> gtDifference = evalMult(context, gt, difference);
+
+        comparisonResults results;
+        results.eq = counted.output(eq);
+        results.gt = counted.output(gt);
+        results.gteq = counted.output(evalAdd(context, gt, eq));
+        results.lt = counted.output(evalSub(context, lteq, eq));
+        results.lteq = counted.output(lteq);
+        results.max = counted.output(evalAdd(context, c2, gtDifference));
+        results.min = counted.output(evalSub(context, c1, gtDifference));
+        return results;
+    }
+    ciphertextGraph graph;
+
+    // Compute difference = c1 - c2 and its powers (the powers of two are shared by sign and equality)
+    size_t first = graph.input(c1);
+    size_t second = graph.input(c2);
+    size_t difference = graph.add([context](const nodeValues &operands) { return evalSub(context, operands[0], operands[1]); }, {first, second});
+
+    interpolationPlan signPlan = getInterpolationPlan("sign", evalSignPoints, cc);
+    std::vector<uint> exponents = signPlan.powers;
+    exponents.push_back(p - 1);
+    std::vector<size_t> powerNodes = addPowerNodes(graph, difference, exponents, cc);
+    size_t cSign = addPSNode(graph, powerNodes, signPlan, cc);
+
+    // eq = 1 - (c1 - c2)^{p-1} (see equalZero)
+    size_t eq = graph.add([context, one](const nodeValues &operands) {
+        return evalAdd(context, evalNegate(context, operands[0]), one);
+    }, {powerNodes[p-2]});
+
+    // gt = (sign + 1 - eq) x 2^{-1} mod p
+    size_t gt = graph.add([context, one, half](const nodeValues &operands) {
+        return evalMult(context, evalAdd(context, evalSub(context, operands[0], operands[1]), one), half);
+    }, {cSign, eq});
+
+    // Affine identities for the remaining predicates
+    size_t gteq = graph.add([context](const nodeValues &operands) { return evalAdd(context, operands[0], operands[1]); }, {gt, eq});
+    size_t lteq = graph.add([context, one](const nodeValues &operands) { return evalAdd(context, evalNegate(context, operands[0]), one); }, {gt});
+    size_t lt = graph.add([context](const nodeValues &operands) { return evalSub(context, operands[0], operands[1]); }, {lteq, eq});
+
+    // max = c2 + gt x (c1 - c2), min = c1 - gt x (c1 - c2)
+    size_t gtDifference = graph.add([context](const nodeValues &operands) { return evalMult(context, operands[0], operands[1]); }, {gt, difference});
+    size_t max = graph.add([context](const nodeValues &operands) { return evalAdd(context, operands[0], operands[1]); }, {second, gtDifference});
+    size_t min = graph.add([context](const nodeValues &operands) { return evalSub(context, operands[0], operands[1]); }, {first, gtDifference});
+
+    std::vector<size_t> outputs = {eq, gt, gteq, lt, lteq, max, min};
+    for (uint i = 0; i < outputs.size(); i++) {
+        graph.keep(outputs[i]);
+    }
+    graph.run(evalThreads);
+
+    comparisonResults results;
+    results.eq = counted.output(graph.value(eq));
+    results.gt = counted.output(graph.value(gt));
+    results.gteq = counted.output(graph.value(gteq));
+    results.lt = counted.output(graph.value(lt));
+    results.lteq = counted.output(graph.value(lteq));
+    results.max = counted.output(graph.value(max));
+    results.min = counted.output(graph.value(min));
+    return results;
+}
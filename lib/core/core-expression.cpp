@@ -0,0 +1,348 @@
+// Created on February 13 2023
+// By Julen Bernabe Rodriguez <julen.bernabe@tecnalia.com>
+// Copyright (c) 2023 Tecnalia Research & Innovation
+
+/*
+ * Evaluation core: lazy expressions
+ */
+
+#include "scheme/bgvrns/cryptocontext-bgvrns.h"
+#include "gen-cryptocontext.h"
+
+#include <iostream>
+#include <vector>
+#include <map>
+#include <set>
+#include <algorithm>
+
+using namespace lbcrypto;
+
+/*
+ * Operations of an expression. The predicates compare their operand with zero.
+ */
+enum ExpressionOp {
+    EXPR_INPUT,                 // input ciphertext
+    EXPR_ADD,                   // a + b
+    EXPR_SUB,                   // a - b
+    EXPR_MUL,                   // a x b
+    EXPR_NEGATE,                // -a
+    EXPR_SIGN,                  // sign(a)
+    EXPR_EQUAL_ZERO,            // a == 0
+    EXPR_GREATER_ZERO,          // a > 0
+    EXPR_GREATER_EQUAL_ZERO,    // a >= 0
+    EXPR_LOWER_ZERO,            // a < 0
+    EXPR_LOWER_EQUAL_ZERO       // a <= 0
+};
+
+/**
+ * @brief Node of an expression
+ * 
+ * @param op operation of the node
+ * @param operands nodes of the operands (the index of the ciphertext for inputs)
+ */
+struct ExpressionNode {
+    ExpressionOp op;
+    std::vector<size_t> operands;
+};
+
+typedef struct ExpressionNode expressionNode;
+
+bool isPredicate(ExpressionOp op) {
+    return op >= EXPR_SIGN;
+}
+
+/*
+ * Predicate of -a in terms of a predicate of a: a > 0 for -a < 0, and so on (sign is negated by the caller).
+ */
+ExpressionOp mirrorPredicate(ExpressionOp op) {
+    switch (op) {
+        case EXPR_GREATER_ZERO:
+            return EXPR_LOWER_ZERO;
+        case EXPR_GREATER_EQUAL_ZERO:
+            return EXPR_LOWER_EQUAL_ZERO;
+        case EXPR_LOWER_ZERO:
+            return EXPR_GREATER_ZERO;
+        case EXPR_LOWER_EQUAL_ZERO:
+            return EXPR_GREATER_EQUAL_ZERO;
+        default:
+            return op;
+    }
+}
+
+/*
+ * Builds expressions over ciphertexts without evaluating them. Nodes are hash-consed, so an identical subtree
+ * is always the same node (common subexpressions are evaluated once), and they are kept in a canonical form:
+ * b - a is -(a - b) for inputs created in the order a, b, and the predicates of a negated value are the mirrored
+ * predicates of the value, so e.g. gt(a, b) and gt(b, a) share the powers of a single difference.
+ * Nothing is computed until evaluate(), which only evaluates the nodes the requested outputs depend on.
+ */
+template <class Tools>
+class ExpressionBuilder {
+public:
+    explicit ExpressionBuilder(Tools cc) : cc(cc) {}
+
+    // Node of an input (the same ciphertext is always the same node)
+    size_t input(Ciphertext<DCRTPoly> ciphertext) {
+        for (size_t i = 0; i < inputs.size(); i++) {
+            if (inputs[i] == ciphertext) {
+                return node(EXPR_INPUT, {i});
+            }
+        }
+        inputs.push_back(ciphertext);
+        return node(EXPR_INPUT, {inputs.size() - 1});
+    }
+
+    size_t add(size_t a, size_t b) {
+        return node(EXPR_ADD, {std::min(a, b), std::max(a, b)});
+    }
+
+    size_t sub(size_t a, size_t b) {
+        if (a > b) {
+            return negate(node(EXPR_SUB, {b, a}));
+        }
+        return node(EXPR_SUB, {a, b});
+    }
+
+    size_t mul(size_t a, size_t b) {
+        return node(EXPR_MUL, {std::min(a, b), std::max(a, b)});
+    }
+
+    size_t negate(size_t a) {
+        if (nodes[a].op == EXPR_NEGATE) {
+            return nodes[a].operands[0];
+        }
+        return node(EXPR_NEGATE, {a});
+    }
+
+    // Predicate of a (compared with zero)
+    size_t predicate(ExpressionOp op, size_t a) {
+        if (nodes[a].op != EXPR_NEGATE) {
+            return node(op, {a});
+        }
+        size_t value = nodes[a].operands[0];
+        if (op == EXPR_SIGN) {
+            return negate(node(EXPR_SIGN, {value}));
+        }
+        return node(mirrorPredicate(op), {value});
+    }
+
+    size_t equal(size_t a, size_t b) {
+        return predicate(EXPR_EQUAL_ZERO, sub(a, b));
+    }
+
+    size_t gt(size_t a, size_t b) {
+        return predicate(EXPR_GREATER_ZERO, sub(a, b));
+    }
+
+    size_t gteq(size_t a, size_t b) {
+        return predicate(EXPR_GREATER_EQUAL_ZERO, sub(a, b));
+    }
+
+    size_t lt(size_t a, size_t b) {
+        return predicate(EXPR_LOWER_ZERO, sub(a, b));
+    }
+
+    size_t lteq(size_t a, size_t b) {
+        return predicate(EXPR_LOWER_EQUAL_ZERO, sub(a, b));
+    }
+
+    // max = b + gt x (a - b), as in compareAll
+    size_t max(size_t a, size_t b) {
+        size_t difference = sub(a, b);
+        return add(b, mul(gt(a, b), difference));
+    }
+
+    // min = a - gt x (a - b), as in compareAll
+    size_t min(size_t a, size_t b) {
+        size_t difference = sub(a, b);
+        return sub(a, mul(gt(a, b), difference));
+    }
+
+    size_t size() const {
+        return nodes.size();
+    }
+
+    /**
+     * @brief Evaluate some nodes
+     * 
+     * Only the nodes the outputs depend on are evaluated, and the remaining ones are dropped. The predicates of
+     * the same value share its powers, and when several order predicates of a value are requested they are
+     * derived from its sign and equality polynomials (as in compareAll) instead of one interpolation each.
+     * 
+     * @param outputs nodes to be evaluated
+     * @return std::vector<Ciphertext<DCRTPoly>> values of the outputs (in the same order)
+     */
+    std::vector<Ciphertext<DCRTPoly>> evaluate(const std::vector<size_t> &outputs) {
+        CountedOperation counted("expression", inputs);
+        // Mark the nodes the outputs depend on (operands always precede their nodes)
+        std::vector<bool> live(nodes.size(), false);
+        for (size_t i = 0; i < outputs.size(); i++) {
+            live[outputs[i]] = true;
+        }
+        std::map<size_t, std::set<ExpressionOp>> predicates;
+        for (size_t i = nodes.size(); i > 0; i--) {
+            if (!live[i-1]) {
+                continue;
+            }
+            for (size_t j = 0; j < nodes[i-1].operands.size() && nodes[i-1].op != EXPR_INPUT; j++) {
+                live[nodes[i-1].operands[j]] = true;
+            }
+            if (isPredicate(nodes[i-1].op)) {
+                predicates[nodes[i-1].operands[0]].insert(nodes[i-1].op);
+            }
+        }
+
+        CryptoContext<DCRTPoly> context = cc.cryptoContext;
+        ciphertextGraph graph;
+        std::vector<size_t> graphNodes(nodes.size(), noNode);
+        std::map<size_t, std::map<ExpressionOp, size_t>> predicateNodes;
+        for (size_t i = 0; i < nodes.size(); i++) {
+            if (!live[i]) {
+                continue;
+            }
+            const std::vector<size_t> &operands = nodes[i].operands;
+            switch (nodes[i].op) {
+                case EXPR_INPUT:
+                    graphNodes[i] = graph.input(inputs[operands[0]]);
+                    break;
+                case EXPR_ADD:
+                    graphNodes[i] = graph.add([context](const nodeValues &values) {
+                        return evalAdd(context, values[0], values[1]);
+                    }, {graphNodes[operands[0]], graphNodes[operands[1]]});
+                    break;
+                case EXPR_SUB:
+                    graphNodes[i] = graph.add([context](const nodeValues &values) {
+                        return evalSub(context, values[0], values[1]);
+                    }, {graphNodes[operands[0]], graphNodes[operands[1]]});
+                    break;
+                case EXPR_MUL:
+                    graphNodes[i] = graph.add([context](const nodeValues &values) {
+                        return evalMult(context, values[0], values[1]);
+                    }, {graphNodes[operands[0]], graphNodes[operands[1]]});
+                    break;
+                case EXPR_NEGATE:
+                    graphNodes[i] = graph.add([context](const nodeValues &values) {
+                        return evalNegate(context, values[0]);
+                    }, {graphNodes[operands[0]]});
+                    break;
+                default:
+                    if (predicateNodes.find(operands[0]) == predicateNodes.end()) {
+                        predicateNodes[operands[0]] = addPredicateNodes(graph, graphNodes[operands[0]], predicates[operands[0]]);
+                    }
+                    graphNodes[i] = predicateNodes[operands[0]][nodes[i].op];
+            }
+        }
+
+        for (size_t i = 0; i < outputs.size(); i++) {
+            graph.keep(graphNodes[outputs[i]]);
+        }
+        graph.run(evalThreads);
+
+        std::vector<Ciphertext<DCRTPoly>> results;
+        for (size_t i = 0; i < outputs.size(); i++) {
+            results.push_back(counted.output(graph.value(graphNodes[outputs[i]])));
+        }
+        return results;
+    }
+
+private:
+    // Node with some operation and operands, reusing the existing one if any
+    size_t node(ExpressionOp op, std::vector<size_t> operands) {
+        std::pair<ExpressionOp, std::vector<size_t>> key(op, operands);
+        auto existing = index.find(key);
+        if (existing != index.end()) {
+            return existing->second;
+        }
+        expressionNode added;
+        added.op = op;
+        added.operands = operands;
+        nodes.push_back(added);
+        index[key] = nodes.size() - 1;
+        return nodes.size() - 1;
+    }
+
+    /*
+     * Adds the nodes of the predicates of a value to the task graph, over a single set of its powers.
+     */
+    std::map<ExpressionOp, size_t> addPredicateNodes(ciphertextGraph &graph, size_t value, const std::set<ExpressionOp> &ops) {
+        int p = cc.cryptoContext->GetCryptoParameters()->GetPlaintextModulus();
+        CryptoContext<DCRTPoly> context = cc.cryptoContext;
+        Plaintext one = encodeCoefficient(1, cc);
+
+        uint orderPredicates = 0;
+        for (ExpressionOp op : ops) {
+            orderPredicates += op != EXPR_SIGN && op != EXPR_EQUAL_ZERO;
+        }
+        bool fromSign = orderPredicates >= 2 || (orderPredicates == 1 && ops.count(EXPR_SIGN));
+        bool needsEqual = fromSign || ops.count(EXPR_EQUAL_ZERO);
+
+        // Plans of the interpolated predicates, and the powers they need
+        std::map<ExpressionOp, interpolationPlan> plans;
+        if (fromSign || ops.count(EXPR_SIGN)) {
+            plans[EXPR_SIGN] = getInterpolationPlan("sign", evalSignPoints, cc);
+        }
+        if (!fromSign) {
+            for (ExpressionOp op : ops) {
+                if (op == EXPR_GREATER_ZERO) {
+                    plans[op] = getInterpolationPlan("greater", evalGreaterPoints, cc);
+                } else if (op == EXPR_GREATER_EQUAL_ZERO) {
+                    plans[op] = getInterpolationPlan("greaterEqual", evalGreaterEqualPoints, cc);
+                } else if (op == EXPR_LOWER_ZERO) {
+                    plans[op] = getInterpolationPlan("lower", evalLowerPoints, cc);
+                } else if (op == EXPR_LOWER_EQUAL_ZERO) {
+                    plans[op] = getInterpolationPlan("lowerEqual", evalLowerEqualPoints, cc);
+                }
+            }
+        }
+        std::vector<uint> exponents;
+        for (auto &plan : plans) {
+            exponents.insert(exponents.end(), plan.second.powers.begin(), plan.second.powers.end());
+        }
+        if (needsEqual) {
+            exponents.push_back(p - 1);
+        }
+        std::vector<size_t> powerNodes = addPowerNodes(graph, value, exponents, cc);
+
+        std::map<ExpressionOp, size_t> result;
+        for (auto &plan : plans) {
+            result[plan.first] = addPSNode(graph, powerNodes, plan.second, cc);
+        }
+        if (needsEqual) {
+            // a == 0 is 1 - a^{p-1} (see equalZero)
+            result[EXPR_EQUAL_ZERO] = graph.add([context, one](const nodeValues &values) {
+                return evalAdd(context, evalNegate(context, values[0]), one);
+            }, {powerNodes[p-2]});
+        }
+        if (fromSign) {
+            // Same identities as compareAll: gt = (sign + 1 - eq) / 2, gteq = gt + eq, lteq = 1 - gt, lt = lteq - eq
+            Plaintext half = encodeCoefficient((p + 1) / 2, cc);
+            size_t eq = result[EXPR_EQUAL_ZERO];
+            size_t gt = graph.add([context, one, half](const nodeValues &values) {
+                return evalMult(context, evalAdd(context, evalSub(context, values[0], values[1]), one), half);
+            }, {result[EXPR_SIGN], eq});
+            result[EXPR_GREATER_ZERO] = gt;
+            if (ops.count(EXPR_GREATER_EQUAL_ZERO)) {
+                result[EXPR_GREATER_EQUAL_ZERO] = graph.add([context](const nodeValues &values) {
+                    return evalAdd(context, values[0], values[1]);
+                }, {gt, eq});
+            }
+            if (ops.count(EXPR_LOWER_EQUAL_ZERO) || ops.count(EXPR_LOWER_ZERO)) {
+                size_t lteq = graph.add([context, one](const nodeValues &values) {
+                    return evalAdd(context, evalNegate(context, values[0]), one);
+                }, {gt});
+                result[EXPR_LOWER_EQUAL_ZERO] = lteq;
+                if (ops.count(EXPR_LOWER_ZERO)) {
+                    result[EXPR_LOWER_ZERO] = graph.add([context](const nodeValues &values) {
+                        return evalSub(context, values[0], values[1]);
+                    }, {lteq, eq});
+                }
+            }
+        }
+        return result;
+    }
+
+    Tools cc;
+    std::vector<expressionNode> nodes;
+    std::vector<Ciphertext<DCRTPoly>> inputs;
+    std::map<std::pair<ExpressionOp, std::vector<size_t>>, size_t> index;
+};
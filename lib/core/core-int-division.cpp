@@ -0,0 +1,289 @@
+// Created on February 13 2023
+// By Julen Bernabe Rodriguez <julen.bernabe@tecnalia.com>
+// Copyright (c) 2023 Tecnalia Research & Innovation
+
+/*
+ * Evaluation core: integer division
+ */
+
+#include "scheme/bgvrns/cryptocontext-bgvrns.h"
+#include "gen-cryptocontext.h"
+
+#include <iostream>
+#include <fstream>
+#include <limits>
+#include <iterator>
+#include <random>
+#include <time.h>
+#include <utility>
+
+interpolationPoints integerPositiveDivisionPoints(int divisor, int p) {
+    interpolationPoints ip;
+    for (int i = 0; i < p; i++) {
+        ip.x.push_back(i);
+        ip.fx.push_back(i / divisor);
+    }
+    return ip;
+}
+
+interpolationPoints integerDivisionPoints(int divisor, int p) {
+    interpolationPoints ip;
+    for (int i = 0; i < p; i++) {
+        if (i <= (p-1)/2) {
+            ip.x.push_back(i);
+            ip.fx.push_back(i / divisor);
+        } else {
+            ip.x.push_back(-(p-i));
+            ip.fx.push_back(-(p-i) / divisor);
+        }
+        
+    }
+    return ip;
+}
+
+template <class Tools>
+Ciphertext<DCRTPoly> intPubDivision(Ciphertext<DCRTPoly> dividend, int divisor, Tools cc) {
+    CountedOperation counted("intPubDivision", {dividend});
+    if (divisor != 0) {
+        interpolationPlan plan = getInterpolationPlan("division/" + std::to_string(divisor), [divisor](int p) { return integerDivisionPoints(divisor, p); }, cc);
+        Ciphertext<DCRTPoly> evaluation = evalPolynomial(dividend, plan, cc);
+        return counted.output(evaluation);
+    } else {
+        // Division by zero returns zero, obtained from the dividend without a fresh encryption
+        Ciphertext<DCRTPoly> evaluation = evalSub(cc.cryptoContext, dividend, dividend);
+        return counted.output(evaluation); 
+    }
+}
+
+/**
+ * @brief Quotient polynomials of the private division, in terms of the divisor
+ * 
+ * With c_{i,j} the coefficient j of the quotient polynomial x / i, the quotient by an encrypted divisor d is
+ * sum_j x^j R_j(d), where R_j(d) = sum_i c_{i,j} delta_i(d) and delta_i(d) = [d == i] = -sum_{k=1}^{p-1} i^{p-1-k} d^k.
+ * So R_j is the polynomial interpolating i -> c_{i,j} (the one-hot indicators never need to be computed),
+ * and its coefficients only depend on p: they are computed once and kept in the plan cache. They are encoded on use
+ * (see planCoefficient), as about p^2 encoded plaintexts per context would be too many to keep.
+ * Divisors are signed: residue i > (p-1)/2 is the divisor -(p-i). Division by zero gives zero.
+ * 
+ * @param cc cryptographical context
+ * @return std::vector<interpolationPlan> containing the plans of R_0, ..., R_{p-1}
+ */
+template <class Tools>
+std::vector<interpolationPlan> privateDivisionPlans(Tools cc) {
+    int p = cc.cryptoContext->GetCryptoParameters()->GetPlaintextModulus();
+
+    // Quotient tables of every divisor, only computed if some R_j is not cached
+    std::vector<std::vector<int64_t>> quotientTables;
+    std::function<void()> computeQuotientTables = [&]() {
+        if (!quotientTables.empty()) {
+            return;
+        }
+        quotientTables.resize(p);
+        for (int i = 1; i < p; i++) {
+            int divisor = i <= (p-1)/2 ? i : -(p-i);
+            quotientTables[i] = getInterpolationCoefficients("division/" + std::to_string(divisor), [divisor](int p) { return integerDivisionPoints(divisor, p); }, p);
+        }
+    };
+
+    // Only the coefficients are cached: p plans of up to p encoded coefficients would be kept for every context
+    std::vector<interpolationPlan> plans;
+    for (int j = 0; j < p; j++) {
+        plans.push_back(makeInterpolationPlan(getInterpolationCoefficients("privateDivision/" + std::to_string(j), [&, j](int p) {
+            computeQuotientTables();
+            interpolationPoints ip;
+            for (int i = 0; i < p; i++) {
+                ip.x.push_back(i);
+                ip.fx.push_back(i == 0 ? 0 : quotientTables[i][j]);
+            }
+            return ip;
+        }, p), cc, false));
+    }
+    return plans;
+}
+
+/**
+ * @brief Encrypted divisor ready to divide any number of dividends
+ * 
+ * @param quotientCoefficients R_j(d) for j = 0, ..., p-1 (see privateDivisionPlans)
+ */
+struct PreparedDivisor {
+    std::vector<Ciphertext<DCRTPoly>> quotientCoefficients;
+};
+
+typedef struct PreparedDivisor preparedDivisor;
+
+/**
+ * @brief Add the nodes of R_0(d), ..., R_{p-1}(d) to a task graph (see privateDivisionPlans)
+ * 
+ * Each R_j(d) is a combination of the powers of d with public coefficients (plaintext products only), and the
+ * powers are freed once every R_j(d) has been computed.
+ * 
+ * @param graph task graph
+ * @param divisor node of the encrypted divisor d
+ * @param plans plans of R_0, ..., R_{p-1}
+ * @param cc cryptographical context
+ * @return std::vector<size_t> nodes of R_0(d), ..., R_{p-1}(d)
+ */
+template <class Tools>
+std::vector<size_t> addQuotientCoefficientNodes(ciphertextGraph &graph, size_t divisor, const std::vector<interpolationPlan> &plans, Tools cc) {
+    std::vector<uint> exponents;
+    for (uint n = 1; n < plans.size(); n++) {
+        exponents.push_back(n);
+    }
+    std::vector<size_t> divisorPowers = addPowerNodes(graph, divisor, exponents, cc);
+
+    std::vector<size_t> quotientCoefficients;
+    for (uint j = 0; j < plans.size(); j++) {
+        interpolationPlan plan = plans[j];
+        quotientCoefficients.push_back(graph.add([plan, cc](const nodeValues &powers) {
+            return evalPowerCombination(powers, plan, cc);
+        }, divisorPowers));
+    }
+    return quotientCoefficients;
+}
+
+/**
+ * @brief Add the nodes of the quotient sum_j x^j R_j(d) to a task graph
+ * 
+ * Each product x^j R_j(d) runs as soon as both factors are ready, and frees them once done.
+ * 
+ * @param graph task graph
+ * @param dividend node of the encrypted dividend x
+ * @param quotientCoefficients nodes of R_0(d), ..., R_{p-1}(d)
+ * @param cc cryptographical context
+ * @return size_t node of the quotient
+ */
+template <class Tools>
+size_t addPrivDivisionNodes(ciphertextGraph &graph, size_t dividend, const std::vector<size_t> &quotientCoefficients, Tools cc) {
+    CryptoContext<DCRTPoly> context = cc.cryptoContext;
+    std::vector<uint> exponents;
+    for (uint n = 1; n < quotientCoefficients.size(); n++) {
+        exponents.push_back(n);
+    }
+    std::vector<size_t> dividendPowers = addPowerNodes(graph, dividend, exponents, cc);
+
+    // The products are accumulated without relinearization
+    std::vector<size_t> terms;
+    for (uint j = 1; j < quotientCoefficients.size(); j++) {
+        terms.push_back(graph.add([context](const nodeValues &factors) {
+            return evalMultNoRelin(context, factors[0], factors[1]);
+        }, {dividendPowers[j-1], quotientCoefficients[j]}));
+    }
+    // Relinearize the accumulated sum only once
+    return graph.add([context](const nodeValues &operands) {
+        return evalAdd(context, relinearize(context, operands[0]), operands[1]);
+    }, {addSumNodes(graph, terms, cc), quotientCoefficients[0]});
+}
+
+/**
+ * @brief Compute the quotient sum_j x^j R_j(d) streaming the powers of the dividend (see streamPowers)
+ * 
+ * Each product x^j R_j(d) is accumulated as soon as x^j is produced, and both factors are released once used
+ * (R_j(d) is only freed if the caller moved its vector in, rather than keeping it as a prepared divisor does).
+ * 
+ * @param dividend the encrypted dividend x
+ * @param quotientCoefficients R_0(d), ..., R_{p-1}(d)
+ * @param cc cryptographical context
+ * @return Ciphertext<DCRTPoly> containing the quotient x / d
+ */
+template <class Tools>
+Ciphertext<DCRTPoly> streamPrivDivision(Ciphertext<DCRTPoly> dividend, std::vector<Ciphertext<DCRTPoly>> quotientCoefficients, Tools cc) {
+    Ciphertext<DCRTPoly> sum;
+    streamPowers(dividend, quotientCoefficients.size() - 1, [&](uint j, const Ciphertext<DCRTPoly> &power) {
+        // The products are accumulated without relinearization
+        Ciphertext<DCRTPoly> term = evalMultNoRelin(cc.cryptoContext, power, quotientCoefficients[j]);
+        sum = sum ? evalAdd(cc.cryptoContext, sum, term) : term;
+        quotientCoefficients[j] = nullptr;
+    }, cc);
+    return evalAdd(cc.cryptoContext, relinearize(cc.cryptoContext, sum), quotientCoefficients[0]);
+}
+
+/**
+ * @brief Prepare an encrypted divisor for intPrivDivision
+ * 
+ * The powers of the divisor are computed once (p-2 multiplications), and each R_j(d) is a combination of them
+ * with public coefficients (plaintext products only).
+ * 
+ * @param divisor the encrypted divisor d
+ * @param cc cryptographical context
+ * @return preparedDivisor containing R_0(d), ..., R_{p-1}(d)
+ */
+template <class Tools>
+preparedDivisor prepareDivisor(Ciphertext<DCRTPoly> divisor, Tools cc) {
+    CountedOperation counted("prepareDivisor", {divisor});
+    preparedDivisor prepared;
+    if (streamingEvaluation) {
+        std::vector<Ciphertext<DCRTPoly>> quotientCoefficients = evalPolynomialsStreaming(divisor, privateDivisionPlans(cc), cc);
+        for (uint j = 0; j < quotientCoefficients.size(); j++) {
+            prepared.quotientCoefficients.push_back(counted.output(quotientCoefficients[j]));
+        }
+        return prepared;
+    }
+    ciphertextGraph graph;
+    std::vector<size_t> nodes = addQuotientCoefficientNodes(graph, graph.input(divisor), privateDivisionPlans(cc), cc);
+    for (uint j = 0; j < nodes.size(); j++) {
+        graph.keep(nodes[j]);
+    }
+    graph.run(evalThreads);
+
+    for (uint j = 0; j < nodes.size(); j++) {
+        prepared.quotientCoefficients.push_back(counted.output(graph.value(nodes[j])));
+    }
+    return prepared;
+}
+
+/**
+ * @brief Divide an encrypted dividend by a prepared encrypted divisor
+ * 
+ * Computes sum_j x^j R_j(d): the powers of the dividend and one product per power (p-2 + p-1 multiplications).
+ * 
+ * @param dividend the encrypted dividend x
+ * @param divisor the prepared divisor
+ * @param cc cryptographical context
+ * @return Ciphertext<DCRTPoly> containing the quotient x / d (truncated, as integerDivisionPoints)
+ */
+template <class Tools>
+Ciphertext<DCRTPoly> intPrivDivision(Ciphertext<DCRTPoly> dividend, const preparedDivisor &divisor, Tools cc) {
+    CountedOperation counted("intPrivDivision", {dividend});
+    if (streamingEvaluation) {
+        return counted.output(streamPrivDivision(dividend, divisor.quotientCoefficients, cc));
+    }
+    ciphertextGraph graph;
+    std::vector<size_t> quotientCoefficients;
+    for (uint j = 0; j < divisor.quotientCoefficients.size(); j++) {
+        quotientCoefficients.push_back(graph.input(divisor.quotientCoefficients[j]));
+    }
+    size_t quotient = addPrivDivisionNodes(graph, graph.input(dividend), quotientCoefficients, cc);
+    graph.keep(quotient);
+    graph.run(evalThreads);
+    return counted.output(graph.value(quotient));
+}
+
+/**
+ * @brief Divide an encrypted dividend by an encrypted divisor
+ * 
+ * The powers of the dividend, the powers of the divisor and the R_j(d) are nodes of a single task graph: the
+ * products x^j R_j(d) start as soon as their factors are ready, and every intermediate ciphertext is freed as
+ * soon as it is no longer needed. With streamingEvaluation the powers of both inputs are streamed instead
+ * (see evalPolynomialsStreaming and streamPrivDivision).
+ * 
+ * @param dividend the encrypted dividend x
+ * @param divisor the encrypted divisor d
+ * @param cc cryptographical context
+ * @return Ciphertext<DCRTPoly> containing the quotient x / d (truncated, as integerDivisionPoints)
+ */
+template <class Tools>
+Ciphertext<DCRTPoly> intPrivDivision(Ciphertext<DCRTPoly> dividend, Ciphertext<DCRTPoly> divisor, Tools cc) {
+    CountedOperation counted("intPrivDivision", {dividend, divisor});
+    if (streamingEvaluation) {
+        // The p coefficients R_j(d) stay alive until their product, the powers of both inputs are streamed
+        std::vector<Ciphertext<DCRTPoly>> quotientCoefficients = evalPolynomialsStreaming(divisor, privateDivisionPlans(cc), cc);
+        return counted.output(streamPrivDivision(dividend, std::move(quotientCoefficients), cc));
+    }
+    ciphertextGraph graph;
+    std::vector<size_t> quotientCoefficients = addQuotientCoefficientNodes(graph, graph.input(divisor), privateDivisionPlans(cc), cc);
+    size_t quotient = addPrivDivisionNodes(graph, graph.input(dividend), quotientCoefficients, cc);
+    graph.keep(quotient);
+    graph.run(evalThreads);
+    return counted.output(graph.value(quotient));
+}
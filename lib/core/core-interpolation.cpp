@@ -0,0 +1,682 @@
+// Created on February 13 2023
+// By Julen Bernabe Rodriguez <julen.bernabe@tecnalia.com>
+// Copyright (c) 2023 Tecnalia Research & Innovation
+
+/*
+ * Evaluation core: interpolation
+ */
+
+#include "scheme/bgvrns/cryptocontext-bgvrns.h"
+#include "gen-cryptocontext.h"
+
+#include <iostream>
+#include <fstream>
+#include <limits>
+#include <iterator>
+#include <random>
+
+using namespace lbcrypto;
+
+/** 
+ * @brief Structure for storing X and Y sets from Step 1
+ * 
+ * @param x: array containing the elements of X
+ * @param fx: array containing the elements of Y (the f(x)'s)
+ */
+struct Points {
+    std::vector<int64_t> x;
+    std::vector<int64_t> fx;
+};
+
+typedef struct Points interpolationPoints;
+
+/**
+ * @brief Make coefficients of polynomial be mod p
+ * 
+ * @param px polynomial to be normalized
+ * @param p prime number
+ * @return std::vector<int64_t> containing the normalized coefficients (in [0, p))
+ */
+std::vector<int64_t> normalizePoly(std::vector<int64_t> px, int p) {
+    for (uint i = 0; i < px.size(); i++) {
+        px[i] = modP(px[i], p);
+    }
+    return px;
+}
+/**
+ * @brief Compute the discrete Fourier transform over Z_p: X_k = sum_j x_j omega^{jk}
+ * 
+ * Mixed-radix Cooley-Tukey: a transform of size n = r s (r the smallest prime factor of n) is computed
+ * from r transforms of size s, so the cost is O(n (r_1 + r_2 + ...)) for n = r_1 r_2 ... (O(n log n)
+ * when n is smooth, O(n^2) in the worst case).
+ * 
+ * @param x input values in [0, p)
+ * @param omega primitive n-th root of unity mod p (n = x.size())
+ * @param p prime number
+ * @return std::vector<int64_t> containing the transform
+ */
+std::vector<int64_t> transformModP(const std::vector<int64_t> &x, int64_t omega, int64_t p) {
+    uint n = x.size();
+    if (n == 1) {
+        return x;
+    }
+    uint r = primeFactors(n)[0];
+    uint s = n / r;
+
+    // Transforms of the r decimated sequences x_t, x_{t+r}, x_{t+2r}, ... (root omega^r)
+    int64_t omegaR = clearPower(omega, r, p);
+    std::vector<std::vector<int64_t>> sub(r);
+    for (uint t = 0; t < r; t++) {
+        std::vector<int64_t> decimated(s);
+        for (uint j = 0; j < s; j++) {
+            decimated[j] = x[t + j * r];
+        }
+        sub[t] = transformModP(decimated, omegaR, p);
+    }
+
+    // X_k = sum_t omega^{tk} sub_t[k mod s]
+    std::vector<int64_t> result(n);
+    int64_t omegaK = 1;
+    for (uint k = 0; k < n; k++) {
+        int64_t twiddle = 1;
+        int64_t sum = 0;
+        for (uint t = 0; t < r; t++) {
+            sum = (sum + mulMod(twiddle, sub[t][k % s], p)) % p;
+            twiddle = mulMod(twiddle, omegaK, p);
+        }
+        result[k] = sum;
+        omegaK = mulMod(omegaK, omega, p);
+    }
+    return result;
+}
+/**
+ * @brief Get the interpolation polynomial of a function defined on the whole Z_p
+ * 
+ * The polynomial is sum_a f(a) (1 - (x-a)^{p-1}), whose coefficients are c_0 = f(0),
+ * c_k = -sum_{a != 0} f(a) a^{p-1-k} for 0 < k < p-1 and c_{p-1} = -sum_a f(a).
+ * Writing a = g^j (g a generator of Z_p^*), the sums for all k are a single transform of size p-1.
+ * 
+ * @param values values[a] = f(a) mod p for every a in [0, p)
+ * @param p odd prime number
+ * @return std::vector<int64_t> containing the p coefficients in [0, p)
+ */
+std::vector<int64_t> fullDomainInterpolation(const std::vector<int64_t> &values, int p) {
+    int64_t g = multiplicativeGenerator(p);
+    std::vector<int64_t> valuesOnGenerator(p - 1);
+    int64_t a = 1;
+    for (int j = 0; j < p - 1; j++) {
+        valuesOnGenerator[j] = values[a];
+        a = mulMod(a, g, p);
+    }
+    // sums[e] = sum_j f(g^j) g^{je} = sum_{a != 0} f(a) a^e
+    std::vector<int64_t> sums = transformModP(valuesOnGenerator, g, p);
+
+    std::vector<int64_t> result(p);
+    result[0] = values[0];
+    for (int k = 1; k < p - 1; k++) {
+        result[k] = modP(-sums[p - 1 - k], p);
+    }
+    result[p - 1] = modP(-(sums[0] + values[0]), p);
+    return result;
+}
+/**
+ * @brief Get the interpolation polynomial of arbitrary points in O(n^2)
+ * 
+ * With M(x) = prod_j (x - x_j), the Lagrange polynomial of x_i is M(x) / (x - x_i) divided by its
+ * value at x_i, and each quotient is obtained by synthetic division.
+ * 
+ * @param x points in [0, p) (pairwise distinct)
+ * @param fx values in [0, p)
+ * @param p prime number
+ * @return std::vector<int64_t> containing the x.size() coefficients in [0, p)
+ */
+std::vector<int64_t> genericInterpolation(const std::vector<int64_t> &x, const std::vector<int64_t> &fx, int p) {
+    uint n = x.size();
+    // master[k] is the coefficient of x^k of M(x)
+    std::vector<int64_t> master(n + 1, 0);
+    master[0] = 1;
+    for (uint j = 0; j < n; j++) {
+        for (uint k = j + 1; k > 0; k--) {
+            master[k] = modP(master[k-1] - mulMod(x[j], master[k], p), p);
+        }
+        master[0] = modP(-mulMod(x[j], master[0], p), p);
+    }
+
+    std::vector<int64_t> result(n, 0);
+    std::vector<int64_t> quotient(n);
+    for (uint i = 0; i < n; i++) {
+        if (fx[i] == 0) {
+            continue;
+        }
+        // quotient = M(x) / (x - x_i), and its value at x_i is prod_{j != i} (x_i - x_j)
+        int64_t carry = 0;
+        for (uint k = n; k > 0; k--) {
+            carry = (master[k] + mulMod(carry, x[i], p)) % p;
+            quotient[k-1] = carry;
+        }
+        int64_t denominator = 0;
+        for (uint k = n; k > 0; k--) {
+            denominator = (mulMod(denominator, x[i], p) + quotient[k-1]) % p;
+        }
+        int64_t scalar = mulMod(inverse(denominator, p), fx[i], p);
+        for (uint k = 0; k < n; k++) {
+            result[k] = (result[k] + mulMod(scalar, quotient[k], p)) % p;
+        }
+    }
+    return result;
+}
+/**
+ * @brief Get the Lagrange Polynomial using Lagrange's Interpolation Formula
+ * 
+ * When the points cover the whole Z_p (as every function of this library does), the closed form of
+ * fullDomainInterpolation is used. Otherwise the generic O(n^2) interpolation is used.
+ * 
+ * @param ip interpolation points (struct containing X and Y from Step 1)
+ * @param p prime number
+ * @return std::vector<int64_t> containing the coefficients in [0, p)
+ */
+std::vector<int64_t> getLagrangePoly(interpolationPoints ip, int p) {
+    std::vector<int64_t> x = normalizePoly(ip.x, p);
+    std::vector<int64_t> fx = normalizePoly(ip.fx, p);
+
+    if (p > 2 && (int) x.size() == p) {
+        std::vector<int64_t> values(p);
+        std::vector<bool> covered(p, false);
+        uint distinct = 0;
+        for (int i = 0; i < p; i++) {
+            if (!covered[x[i]]) {
+                covered[x[i]] = true;
+                distinct++;
+            }
+            values[x[i]] = fx[i];
+        }
+        if ((int) distinct == p) {
+            return fullDomainInterpolation(values, p);
+        }
+    }
+    return genericInterpolation(x, fx, p);
+}
+/**
+ * @brief Number of slots of the packed plaintexts of the cryptographical context
+ * 
+ * @param cc cryptographical context
+ * @return usint batch size (the ring dimension if no batch size was set)
+ */
+template <class Tools>
+usint slotCount(Tools cc) {
+    usint batchSize = cc.cryptoContext->GetEncodingParams()->GetBatchSize();
+    return batchSize ? batchSize : cc.cryptoContext->GetRingDimension();
+}
+/**
+ * @brief Encode a public coefficient as a plaintext
+ * 
+ * The coefficient is replicated in every slot, so the products and additions by public constants are
+ * applied slot-wise and every operation works on full packed vectors (see encryptV).
+ * 
+ * @param coefficient coefficient to be encoded
+ * @param cc cryptographical context
+ * @return Plaintext encoding the coefficient in every slot
+ */
+template <class Tools>
+Plaintext encodeCoefficient(int64_t coefficient, Tools cc) {
+    std::vector<int64_t> vectorOfInts(slotCount(cc), coefficient);
+    return cc.cryptoContext->MakePackedPlaintext(vectorOfInts);
+}
+/**
+ * @brief Encode the coefficients of the interpolation polynomial as plaintexts
+ * 
+ * The polynomial is public, so its coefficients are never encrypted: they are multiplied as plaintexts.
+ * 
+ * @param poly polynomial to be encoded
+ * @param cc cryptographical context for the encoding
+ * @return std::vector<Plaintext> array of plaintexts with the encoding of each coefficient
+ */
+template <class Tools>
+std::vector<Plaintext> encodeInterpolator(std::vector<int64_t> poly, Tools cc) {
+    std::vector<Plaintext> result;
+    for (uint i = 0; i < poly.size(); i++){
+        result.push_back(encodeCoefficient(poly[i], cc));
+    }
+    return result;
+}
+/**
+ * @brief Add a vector of ciphertexts as a balanced tree (each level of the tree is computed concurrently)
+ * 
+ * @param terms ciphertexts to be added (at least one)
+ * @param cc cryptographical context
+ * @return Ciphertext<DCRTPoly> ciphertext containing the sum
+ */
+template <class Tools>
+Ciphertext<DCRTPoly> sumCiphertexts(std::vector<Ciphertext<DCRTPoly>> terms, Tools cc) {
+    while (terms.size() > 1) {
+        int half = terms.size() / 2;
+        #pragma omp parallel for num_threads(evalThreads) copyin(activeFrame) if(evalThreads > 1)
+        for (int i = 0; i < half; i++) {
+            terms[i] = evalAdd(cc.cryptoContext, terms[i], terms[terms.size() - 1 - i]);
+        }
+        terms.resize(terms.size() - half);
+    }
+    return terms[0];
+}
+/**
+ * @brief Add the nodes of a balanced sum of ciphertexts to a task graph (pairs as in sumCiphertexts)
+ * 
+ * Each addition runs as soon as its two operands are ready, and frees them once done.
+ * 
+ * @param graph task graph
+ * @param terms nodes of the ciphertexts to be added (at least one)
+ * @param cc cryptographical context
+ * @return size_t node of the sum
+ */
+template <class Tools>
+size_t addSumNodes(ciphertextGraph &graph, std::vector<size_t> terms, Tools cc) {
+    CryptoContext<DCRTPoly> context = cc.cryptoContext;
+    while (terms.size() > 1) {
+        int half = terms.size() / 2;
+        for (int i = 0; i < half; i++) {
+            terms[i] = graph.add([context](const nodeValues &operands) {
+                return evalAdd(context, operands[0], operands[1]);
+            }, {terms[i], terms[terms.size() - 1 - i]});
+        }
+        terms.resize(terms.size() - half);
+    }
+    return terms[0];
+}
+/**
+ * @brief Evaluate Lagrange's Polynomial for some ciphertext c
+ * 
+ * @param powers the powers of c (i.e. {c, c^2, ..., c^{p-1}})
+ * @param polynomial Lagranges Interpolation Polynomial (encoded coefficients)
+ * @param cc cryptographical context
+ * @return Ciphertext<DCRTPoly> ciphertext containing the result of the evaluation
+ */
+template <class Tools>
+Ciphertext<DCRTPoly> evalInterpolator(std::vector<Ciphertext<DCRTPoly>> powers, std::vector<Plaintext> polynomial, Tools cc) {
+    CountedOperation counted("evalInterpolator", {powers.back()});
+    std::vector<Ciphertext<DCRTPoly>> terms(powers.size());
+    // The products by the coefficients are independent of each other. They are plaintext products,
+    // so they need neither relinearization nor key switching.
+    #pragma omp parallel for num_threads(evalThreads) copyin(activeFrame) schedule(dynamic) if(evalThreads > 1)
+    for (int i = 0; i < (int) powers.size(); i++) {
+        terms[i] = evalMult(cc.cryptoContext, powers[i], polynomial[i+1]);
+    }
+    return counted.output(evalAdd(cc.cryptoContext, sumCiphertexts(terms, cc), polynomial[0]));
+}
+/**
+ * @brief Baby-step and giant-step powers used by the Paterson-Stockmeyer evaluation
+ * 
+ * @param babySteps {c, c^2, ..., c^k} (only c and the powers used by the polynomial are set, the rest are nullptr)
+ * @param giantSteps {c^k, c^{2k}, c^{4k}, ..., c^{k 2^m}} with k 2^m <= degree
+ */
+struct PSPowers {
+    std::vector<Ciphertext<DCRTPoly>> babySteps;
+    std::vector<Ciphertext<DCRTPoly>> giantSteps;
+};
+
+typedef struct PSPowers psPowers;
+
+/**
+ * @brief Interpolation polynomial ready to be evaluated
+ * 
+ * @param coefficients coefficients of the polynomial mod p
+ * @param encoded coefficients encoded as plaintexts for the cryptographical context (nullptr for zero coefficients, and
+ *        for every coefficient of the plans encoded on use, see planCoefficient)
+ * @param degree highest exponent with a non-zero coefficient
+ * @param babySteps number of baby steps k of the Paterson-Stockmeyer evaluation
+ * @param powers exponents of the baby steps with some non-zero coefficient, and of the giant steps
+ */
+struct InterpolationPlan {
+    std::vector<int64_t> coefficients;
+    std::vector<Plaintext> encoded;
+    uint degree;
+    uint babySteps;
+    std::vector<uint> powers;
+};
+
+typedef struct InterpolationPlan interpolationPlan;
+
+/*
+ * Encoding of the coefficient i of a plan (encoded now if the plan does not keep its encodings).
+ */
+template <class Tools>
+Plaintext planCoefficient(const interpolationPlan &plan, uint i, Tools cc) {
+    return plan.encoded[i] ? plan.encoded[i] : encodeCoefficient(plan.coefficients[i], cc);
+}
+
+/**
+ * @brief Evaluate a polynomial as a linear combination of all the powers of c
+ * 
+ * Only plaintext products (one per non-zero coefficient), so the result has the depth of the highest power
+ * used. Meant for polynomials evaluated many times over the same powers, where the powers are computed once.
+ * 
+ * @param powers the powers of c (i.e. {c, c^2, ..., c^{p-1}})
+ * @param plan coefficients of the polynomial and their encodings
+ * @param cc cryptographical context
+ * @return Ciphertext<DCRTPoly> ciphertext containing the result of the evaluation
+ */
+template <class Tools>
+Ciphertext<DCRTPoly> evalPowerCombination(const std::vector<Ciphertext<DCRTPoly>> &powers, const interpolationPlan &plan, Tools cc) {
+    CountedOperation counted("evalPowerCombination", {powers.back()});
+    std::vector<uint> used;
+    for (uint i = 1; i <= plan.degree; i++) {
+        if (plan.coefficients[i] != 0) {
+            used.push_back(i);
+        }
+    }
+    std::vector<Ciphertext<DCRTPoly>> terms(used.size());
+    #pragma omp parallel for num_threads(evalThreads) copyin(activeFrame) schedule(dynamic) if(evalThreads > 1)
+    for (int i = 0; i < (int) used.size(); i++) {
+        terms[i] = evalMult(cc.cryptoContext, powers[used[i]-1], planCoefficient(plan, used[i], cc));
+    }
+    // Constant polynomial: start from an encryption of zero derived from c
+    Ciphertext<DCRTPoly> result = terms.empty() ? evalSub(cc.cryptoContext, powers[0], powers[0]) : sumCiphertexts(terms, cc);
+    if (plan.coefficients[0] != 0) {
+        result = evalAdd(cc.cryptoContext, result, planCoefficient(plan, 0, cc));
+    }
+    return counted.output(result);
+}
+/**
+ * @brief Partial result of a Paterson-Stockmeyer evaluation
+ * 
+ * @param ciphertext encrypted part of the result (nullptr when it is zero)
+ * @param constantIndex index of the coefficient still to be added to the encrypted part
+ */
+struct PartialEvaluation {
+    Ciphertext<DCRTPoly> ciphertext;
+    uint constantIndex;
+};
+
+typedef struct PartialEvaluation partialEvaluation;
+
+/**
+ * @brief Number of baby steps for a polynomial of some degree (power of two close to sqrt(stride (degree+1)))
+ * 
+ * Only one in stride baby steps is computed, so the best number of baby steps grows with the stride.
+ * 
+ * @param degree degree of the polynomial
+ * @param stride distance between the exponents with non-zero coefficients (2 for odd and even polynomials)
+ * @return uint number of baby steps k
+ */
+uint babyStepSize(uint degree, uint stride) {
+    std::vector<uint> binaryRep = binaryRepresentationOfExp(stride * (degree + 1));
+    return 1 << (binaryRep.size() / 2);
+}
+/**
+ * @brief Build the evaluation plan of a polynomial
+ * 
+ * Zero coefficients are neither encoded nor multiplied, and only the baby steps with some non-zero
+ * coefficient are computed. For odd polynomials (e.g. sign) only odd baby steps are needed, and for even
+ * polynomials (e.g. equal) only even ones: together with the giant steps, which are powers of two, the
+ * evaluation is x g(x^2) or g(x^2) with half the baby steps.
+ * 
+ * @param poly coefficients of the polynomial mod p
+ * @param cc cryptographical context
+ * @param encoded whether the coefficients are encoded now (or on every use, for plans too large to be kept encoded)
+ * @return interpolationPlan ready to be evaluated
+ */
+template <class Tools>
+interpolationPlan makeInterpolationPlan(std::vector<int64_t> poly, Tools cc, bool encoded = true) {
+    interpolationPlan plan;
+    plan.coefficients = poly;
+    plan.encoded.resize(poly.size());
+    plan.degree = 0;
+    bool hasOdd = false;
+    bool hasEven = false;
+    for (uint i = 0; i < poly.size(); i++) {
+        if (poly[i] != 0) {
+            plan.encoded[i] = encoded ? encodeCoefficient(poly[i], cc) : nullptr;
+            plan.degree = i;
+            hasOdd = hasOdd || i % 2 == 1;
+            hasEven = hasEven || (i > 0 && i % 2 == 0);
+        }
+    }
+    uint stride = hasOdd && hasEven ? 1 : 2;
+    plan.babySteps = babyStepSize(plan.degree, stride);
+
+    // Baby steps c^{i mod k} used by the leaves of the evaluation, then giant steps c^{k 2^j}
+    std::vector<bool> used(plan.babySteps, false);
+    for (uint i = 1; i <= plan.degree; i++) {
+        if (poly[i] != 0 && i % plan.babySteps != 0) {
+            used[i % plan.babySteps] = true;
+        }
+    }
+    for (uint i = 1; i < plan.babySteps; i++) {
+        if (used[i]) {
+            plan.powers.push_back(i);
+        }
+    }
+    for (uint step = plan.babySteps; step <= plan.degree; step *= 2) {
+        plan.powers.push_back(step);
+    }
+    return plan;
+}
+/**
+ * @brief Compute the baby-step and giant-step powers of c needed to evaluate a polynomial
+ * 
+ * @param ladder power ladder of c (powers already in the ladder are reused, and new ones are added to it)
+ * @param plan plan of the polynomial to be evaluated
+ * @param cc cryptographical context
+ * @return psPowers containing the baby steps and giant steps used by the plan
+ */
+template <class Tools>
+psPowers computePSPowers(powerLadder &ladder, const interpolationPlan &plan, Tools cc) {
+    computePowers(ladder, plan.powers, cc);
+
+    psPowers pw;
+    uint k = plan.babySteps;
+    pw.babySteps.resize(k);
+    pw.babySteps[0] = ladder.memo[0];
+    for (uint i = 0; i < plan.powers.size(); i++) {
+        uint n = plan.powers[i];
+        if (n < k) {
+            pw.babySteps[n-1] = ladder.memo[n-1];
+        } else {
+            pw.giantSteps.push_back(ladder.memo[n-1]);
+        }
+    }
+    if (!pw.giantSteps.empty()) {
+        pw.babySteps[k-1] = pw.giantSteps[0];
+    }
+    return pw;
+}
+/**
+ * @brief Compute the baby-step and giant-step powers of c needed to evaluate a polynomial
+ * 
+ * @param ciphertext the ciphertext to use as input
+ * @param plan plan of the polynomial to be evaluated
+ * @param cc cryptographical context
+ * @return psPowers containing the baby steps and giant steps used by the plan
+ */
+template <class Tools>
+psPowers computePSPowers(Ciphertext<DCRTPoly> ciphertext, const interpolationPlan &plan, Tools cc) {
+    powerLadder ladder = initPowerLadder(ciphertext);
+    return computePSPowers(ladder, plan, cc);
+}
+/**
+ * @brief Evaluate sum_{i=from}^{to-1} poly[i] c^{i-from} recursively (Paterson-Stockmeyer)
+ * 
+ * The coefficients are split as q(c) c^{k 2^j} + r(c), where k 2^j is the largest giant step below the length.
+ * Only the products by giant steps are ciphertext-ciphertext multiplications, and they are skipped when q is zero.
+ * 
+ * @param pw baby-step and giant-step powers of c
+ * @param plan coefficients of the polynomial and their encodings
+ * @param from index of the first coefficient
+ * @param to index after the last coefficient
+ * @param cc cryptographical context
+ * @return partialEvaluation containing the encrypted part and the pending constant of the result
+ */
+template <class Tools>
+partialEvaluation evalPSNode(const psPowers &pw, const interpolationPlan &plan, uint from, uint to, Tools cc) {
+    partialEvaluation result;
+    uint k = pw.babySteps.size();
+
+    if (to - from <= k) {
+        // Leaf: linear combination of baby steps with public (non-zero) coefficients
+        result.constantIndex = from;
+        for (uint i = 1; i < to - from; i++) {
+            if (plan.coefficients[from+i] == 0) {
+                continue;
+            }
+            Ciphertext<DCRTPoly> product = evalMult(cc.cryptoContext, pw.babySteps[i-1], planCoefficient(plan, from+i, cc));
+            result.ciphertext = result.ciphertext ? evalAdd(cc.cryptoContext, result.ciphertext, product) : product;
+        }
+        return result;
+    }
+
+    // Largest giant step c^{k 2^j} with k 2^j < to - from
+    uint split = k;
+    uint j = 0;
+    while (2 * split < to - from) {
+        split *= 2;
+        j++;
+    }
+    // q(c) and r(c) are independent: evaluate them as concurrent tasks
+    partialEvaluation high;
+    partialEvaluation low;
+    #pragma omp task shared(high, pw, plan)
+    high = evalPSNode(pw, plan, from + split, to, cc);
+    #pragma omp task shared(low, pw, plan)
+    low = evalPSNode(pw, plan, from, from + split, cc);
+    #pragma omp taskwait
+
+    // Compute q(c) x c^{k 2^j}
+    Ciphertext<DCRTPoly> highPart;
+    if (high.ciphertext) {
+        if (plan.coefficients[high.constantIndex] != 0) {
+            high.ciphertext = evalAdd(cc.cryptoContext, high.ciphertext, planCoefficient(plan, high.constantIndex, cc));
+        }
+        highPart = evalMult(cc.cryptoContext, high.ciphertext, pw.giantSteps[j]);
+    } else if (plan.coefficients[high.constantIndex] != 0) {
+        highPart = evalMult(cc.cryptoContext, pw.giantSteps[j], planCoefficient(plan, high.constantIndex, cc));
+    } else {
+        // q is zero
+        return low;
+    }
+
+    // Add r(c)
+    result.ciphertext = low.ciphertext ? evalAdd(cc.cryptoContext, low.ciphertext, highPart) : highPart;
+    result.constantIndex = low.constantIndex;
+    return result;
+}
+/**
+ * @brief Evaluate a polynomial with public coefficients over precomputed baby-step and giant-step powers
+ * 
+ * @param pw baby-step and giant-step powers of c (computed for the same plan)
+ * @param plan coefficients of the polynomial and their encodings
+ * @param cc cryptographical context
+ * @return Ciphertext<DCRTPoly> ciphertext containing the result of the evaluation
+ */
+template <class Tools>
+Ciphertext<DCRTPoly> evalPS(const psPowers &pw, const interpolationPlan &plan, Tools cc) {
+    partialEvaluation evaluation;
+    #pragma omp parallel num_threads(evalThreads) copyin(activeFrame) if(evalThreads > 1)
+    #pragma omp single
+    evaluation = evalPSNode(pw, plan, 0, plan.degree + 1, cc);
+    if (!evaluation.ciphertext) {
+        // Constant polynomial: start from an encryption of zero derived from c
+        evaluation.ciphertext = evalSub(cc.cryptoContext, pw.babySteps[0], pw.babySteps[0]);
+    }
+    if (plan.coefficients[evaluation.constantIndex] != 0) {
+        evaluation.ciphertext = evalAdd(cc.cryptoContext, evaluation.ciphertext, planCoefficient(plan, evaluation.constantIndex, cc));
+    }
+    return evaluation.ciphertext;
+}
+/**
+ * @brief Add the Paterson-Stockmeyer evaluation of a polynomial to a task graph
+ * 
+ * @param graph task graph
+ * @param powerNodes nodes of the powers of c, from addPowerNodes (with at least the powers of the plan)
+ * @param plan plan of the polynomial to be evaluated
+ * @param cc cryptographical context
+ * @return size_t node of the result of the evaluation
+ */
+template <class Tools>
+size_t addPSNode(ciphertextGraph &graph, const std::vector<size_t> &powerNodes, const interpolationPlan &plan, Tools cc) {
+    std::vector<size_t> inputs = {powerNodes[0]};
+    for (uint i = 0; i < plan.powers.size(); i++) {
+        inputs.push_back(powerNodes[plan.powers[i]-1]);
+    }
+    return graph.add([plan, cc](const nodeValues &powers) {
+        // Every power of the plan is already in the ladder, so computePSPowers only collects them
+        powerLadder ladder = initPowerLadder(powers[0]);
+        ladder.memo.resize(plan.powers.empty() ? 1 : plan.powers.back());
+        for (uint i = 0; i < plan.powers.size(); i++) {
+            ladder.memo[plan.powers[i]-1] = powers[i+1];
+        }
+        return evalPS(computePSPowers(ladder, plan, cc), plan, cc);
+    }, inputs);
+}
+/**
+ * @brief Evaluate several polynomials with public coefficients for some ciphertext c, streaming its powers
+ * 
+ * Each power of c is folded into the results (a plaintext product per non-zero coefficient) as soon as
+ * streamPowers produces it, and dropped once folded: O(log p) ciphertexts are alive besides the results,
+ * instead of the sqrt(p) baby steps of Paterson-Stockmeyer, at the cost of the p-2 products of the ladder.
+ * With evalThreads > 1 the polynomials are folded concurrently.
+ * 
+ * @param ciphertext the ciphertext c
+ * @param plans coefficients of the polynomials and their encodings
+ * @param cc cryptographical context
+ * @return std::vector<Ciphertext<DCRTPoly>> results of the evaluations (in the same order)
+ */
+template <class Tools>
+std::vector<Ciphertext<DCRTPoly>> evalPolynomialsStreaming(Ciphertext<DCRTPoly> ciphertext, const std::vector<interpolationPlan> &plans, Tools cc) {
+    uint degree = 0;
+    for (uint i = 0; i < plans.size(); i++) {
+        degree = std::max(degree, plans[i].degree);
+    }
+    std::vector<Ciphertext<DCRTPoly>> results(plans.size());
+    streamPowers(ciphertext, degree, [&](uint n, const Ciphertext<DCRTPoly> &power) {
+        #pragma omp parallel for num_threads(evalThreads) copyin(activeFrame) if(evalThreads > 1 && plans.size() > 1)
+        for (int i = 0; i < (int) plans.size(); i++) {
+            if (n <= plans[i].degree && plans[i].coefficients[n] != 0) {
+                Ciphertext<DCRTPoly> term = evalMult(cc.cryptoContext, power, planCoefficient(plans[i], n, cc));
+                results[i] = results[i] ? evalAdd(cc.cryptoContext, results[i], term) : term;
+            }
+        }
+    }, cc);
+    for (uint i = 0; i < plans.size(); i++) {
+        if (!results[i]) {
+            // Constant polynomial: start from an encryption of zero derived from c
+            results[i] = evalSub(cc.cryptoContext, ciphertext, ciphertext);
+        }
+        if (plans[i].coefficients[0] != 0) {
+            results[i] = evalAdd(cc.cryptoContext, results[i], planCoefficient(plans[i], 0, cc));
+        }
+    }
+    return results;
+}
+/**
+ * @brief Evaluate a polynomial with public coefficients for some ciphertext c (Paterson-Stockmeyer)
+ * 
+ * With streamingEvaluation the powers of c are streamed instead (see evalPolynomialsStreaming).
+ * 
+ * Needs about sqrt(p) baby steps, log(p) giant steps and sqrt(p) combining products,
+ * instead of the p-1 powers used by evalInterpolator.
+ * 
+ * @param ciphertext the ciphertext c
+ * @param plan coefficients of the polynomial and their encodings
+ * @param cc cryptographical context
+ * @return Ciphertext<DCRTPoly> ciphertext containing the result of the evaluation
+ */
+template <class Tools>
+Ciphertext<DCRTPoly> evalPolynomial(Ciphertext<DCRTPoly> ciphertext, const interpolationPlan &plan, Tools cc) {
+    CountedOperation counted("evalPolynomial", {ciphertext});
+    if (streamingEvaluation) {
+        return counted.output(evalPolynomialsStreaming(ciphertext, {plan}, cc)[0]);
+    }
+    psPowers pw = computePSPowers(ciphertext, plan, cc);
+    return counted.output(evalPS(pw, plan, cc));
+}
+/**
+ * @brief Evaluate a polynomial with public coefficients for some ciphertext c (Paterson-Stockmeyer)
+ * 
+ * @param ciphertext the ciphertext c
+ * @param poly coefficients of the polynomial
+ * @param cc cryptographical context
+ * @return Ciphertext<DCRTPoly> ciphertext containing the result of the evaluation
+ */
+template <class Tools>
+Ciphertext<DCRTPoly> evalPolynomial(Ciphertext<DCRTPoly> ciphertext, std::vector<int64_t> poly, Tools cc) {
+    return evalPolynomial(ciphertext, makeInterpolationPlan(poly, cc), cc);
+}
\ No newline at end of file
@@ -0,0 +1,236 @@
+// Created on February 13 2023
+// By Julen Bernabe Rodriguez <julen.bernabe@tecnalia.com>
+// Copyright (c) 2023 Tecnalia Research & Innovation
+
+/*
+ * Evaluation core: multi-limb integers
+ */
+
+#include "scheme/bgvrns/cryptocontext-bgvrns.h"
+#include "gen-cryptocontext.h"
+
+#include <iostream>
+#include <fstream>
+#include <limits>
+#include <iterator>
+#include <random>
+
+using namespace lbcrypto;
+
+/**
+ * @brief Encrypted non-negative integer wider than the plaintext modulus
+ * 
+ * The value is sum_i limbs[i] base^i with every limb in [0, base), and arithmetic is modulo base^{limbs.size()}.
+ * Carries are computed with intPubDivision on limb sums, so 2 (base - 1) must be a valid signed value mod p:
+ * base <= maxLimbBase(p) (e.g. 65 for p = 257).
+ * 
+ * @param limbs one ciphertext per limb (least significant first)
+ * @param base base of the limbs
+ */
+struct EncryptedInteger {
+    std::vector<Ciphertext<DCRTPoly>> limbs;
+    uint base;
+};
+
+typedef struct EncryptedInteger encryptedInteger;
+
+/**
+ * @brief Comparisons between two encrypted integers
+ * 
+ * @param eq a == b
+ * @param gt a > b
+ * @param gteq a >= b
+ * @param lt a < b
+ * @param lteq a <= b
+ */
+struct IntegerComparisons {
+    Ciphertext<DCRTPoly> eq;
+    Ciphertext<DCRTPoly> gt;
+    Ciphertext<DCRTPoly> gteq;
+    Ciphertext<DCRTPoly> lt;
+    Ciphertext<DCRTPoly> lteq;
+};
+
+typedef struct IntegerComparisons integerComparisons;
+
+/**
+ * @brief Largest base of the limbs supported for some p (limb sums 2 (base - 1) must be <= (p-1)/2)
+ * 
+ * @param p plaintext modulus
+ * @return uint largest base
+ */
+uint maxLimbBase(uint p) {
+    return (p + 3) / 4;
+}
+/**
+ * @brief Encrypt a non-negative integer as limbs (fresh encryptions of the key backend of cc)
+ * 
+ * @param value integer to be encrypted (taken modulo base^numLimbs)
+ * @param base base of the limbs
+ * @param numLimbs number of limbs
+ * @param cc cryptographical context
+ * @return encryptedInteger containing the encrypted limbs
+ */
+template <class Tools>
+encryptedInteger encryptInteger(uint64_t value, uint base, uint numLimbs, Tools cc) {
+    CountedOperation counted("encryptInteger", {});
+    encryptedInteger result;
+    result.base = base;
+    std::vector<int64_t> limbs = toLimbs(value, base, numLimbs);
+    for (uint i = 0; i < numLimbs; i++) {
+        result.limbs.push_back(KeyBackend<Tools>::encrypt({limbs[i]}, cc));
+    }
+    return result;
+}
+/**
+ * @brief Combine (generate, propagate) pairs of consecutive limbs into prefix groups (Sklansky's parallel prefix)
+ * 
+ * On return generate[i] is the group generate of limbs [from, i]: for carries, the carry out of limb i
+ * (with no carry into limb from); for comparisons, a > b restricted to those limbs. The group of a higher
+ * part (G, P) and a lower part (G', P') is (G + P G', P P'), so the tree has depth ceil(log2(to - from)).
+ * 
+ * @param generate generate of each limb (replaced by the group generates)
+ * @param propagate propagate of each limb (replaced by the group propagates if needPropagate)
+ * @param from first limb
+ * @param to limb after the last one
+ * @param needPropagate whether the group propagates of [from, i] are needed by the caller
+ * @param cc cryptographical context
+ */
+template <class Tools>
+void limbPrefix(std::vector<Ciphertext<DCRTPoly>> &generate, std::vector<Ciphertext<DCRTPoly>> &propagate, uint from, uint to, bool needPropagate, Tools cc) {
+    if (to - from <= 1) {
+        return;
+    }
+    uint mid = (from + to) / 2;
+    limbPrefix(generate, propagate, from, mid, true, cc);
+    limbPrefix(generate, propagate, mid, to, true, cc);
+
+    // Every prefix of the higher half absorbs the whole lower half
+    #pragma omp parallel for num_threads(evalThreads) copyin(activeFrame) if(evalThreads > 1)
+    for (int i = mid; i < (int) to; i++) {
+        generate[i] = evalAdd(cc.cryptoContext, generate[i], evalMult(cc.cryptoContext, propagate[i], generate[mid-1]));
+        if (needPropagate) {
+            propagate[i] = evalMult(cc.cryptoContext, propagate[i], propagate[mid-1]);
+        }
+    }
+}
+/**
+ * @brief Recompose the limbs of a sum (or difference) from the limb-wise values and the carries
+ * 
+ * limb_i = value_i + sign c_i - sign base c_{i+1}, where c_i is the carry (or borrow) into limb i.
+ * 
+ * @param values limb-wise sums (or differences)
+ * @param carries carries[i] is the carry out of limb i
+ * @param negative true for borrows (subtraction), false for carries (addition)
+ * @param base base of the limbs
+ * @param cc cryptographical context
+ * @return encryptedInteger containing the limbs of the result
+ */
+template <class Tools>
+encryptedInteger applyCarries(std::vector<Ciphertext<DCRTPoly>> values, std::vector<Ciphertext<DCRTPoly>> carries, bool negative, uint base, Tools cc) {
+    encryptedInteger result;
+    result.base = base;
+    Plaintext encodedBase = encodeCoefficient(base, cc);
+    for (uint i = 0; i < values.size(); i++) {
+        Ciphertext<DCRTPoly> limb = values[i];
+        if (i > 0) {
+            limb = negative ? evalSub(cc.cryptoContext, limb, carries[i-1]) : evalAdd(cc.cryptoContext, limb, carries[i-1]);
+        }
+        // The carry out of the last limb only reduces that limb (arithmetic modulo base^numLimbs)
+        Ciphertext<DCRTPoly> carried = evalMult(cc.cryptoContext, carries[i], encodedBase);
+        limb = negative ? evalAdd(cc.cryptoContext, limb, carried) : evalSub(cc.cryptoContext, limb, carried);
+        result.limbs.push_back(limb);
+    }
+    return result;
+}
+/**
+ * @brief Add two encrypted integers (modulo base^numLimbs)
+ * 
+ * Limb i generates a carry if a_i + b_i >= base (intPubDivision by base) and propagates the incoming carry
+ * if a_i + b_i == base - 1. All the interpolations are independent, and the carries are combined with a
+ * log-depth parallel prefix instead of rippling through the limbs.
+ * 
+ * @param a first integer
+ * @param b second integer (same base and number of limbs)
+ * @param cc cryptographical context
+ * @return encryptedInteger containing a + b
+ */
+template <class Tools>
+encryptedInteger addIntegers(encryptedInteger a, encryptedInteger b, Tools cc) {
+    CountedOperation counted("addIntegers", a.limbs);
+    uint n = a.limbs.size();
+    std::vector<Ciphertext<DCRTPoly>> sums(n);
+    std::vector<Ciphertext<DCRTPoly>> generate(n);
+    std::vector<Ciphertext<DCRTPoly>> propagate(n);
+    Plaintext almostBase = encodeCoefficient(a.base - 1, cc);
+    for (uint i = 0; i < n; i++) {
+        sums[i] = evalAdd(cc.cryptoContext, a.limbs[i], b.limbs[i]);
+        generate[i] = intPubDivision(sums[i], a.base, cc);
+        propagate[i] = equalZero(evalSub(cc.cryptoContext, sums[i], almostBase), cc);
+    }
+    limbPrefix(generate, propagate, 0, n, false, cc);
+    encryptedInteger result = applyCarries(sums, generate, false, a.base, cc);
+    counted.output(result.limbs.back());
+    return result;
+}
+/**
+ * @brief Subtract two encrypted integers (modulo base^numLimbs)
+ * 
+ * Limb i generates a borrow if a_i - b_i < 0, obtained as -((a_i - b_i - (base - 1)) / base) with intPubDivision
+ * (truncated division), and propagates the incoming borrow if a_i == b_i.
+ * 
+ * @param a first integer
+ * @param b second integer (same base and number of limbs)
+ * @param cc cryptographical context
+ * @return encryptedInteger containing a - b
+ */
+template <class Tools>
+encryptedInteger subIntegers(encryptedInteger a, encryptedInteger b, Tools cc) {
+    CountedOperation counted("subIntegers", a.limbs);
+    uint n = a.limbs.size();
+    std::vector<Ciphertext<DCRTPoly>> differences(n);
+    std::vector<Ciphertext<DCRTPoly>> generate(n);
+    std::vector<Ciphertext<DCRTPoly>> propagate(n);
+    Plaintext almostBase = encodeCoefficient(a.base - 1, cc);
+    for (uint i = 0; i < n; i++) {
+        differences[i] = evalSub(cc.cryptoContext, a.limbs[i], b.limbs[i]);
+        generate[i] = evalNegate(cc.cryptoContext, intPubDivision(evalSub(cc.cryptoContext, differences[i], almostBase), a.base, cc));
+        propagate[i] = equalZero(differences[i], cc);
+    }
+    limbPrefix(generate, propagate, 0, n, false, cc);
+    encryptedInteger result = applyCarries(differences, generate, true, a.base, cc);
+    counted.output(result.limbs.back());
+    return result;
+}
+/**
+ * @brief Compare two encrypted integers lexicographically, from the limb-wise gt and equal
+ * 
+ * a > b is gt_{n-1} + eq_{n-1} (gt_{n-2} + eq_{n-2} (...)), the same prefix combination as the carries,
+ * and a == b is the product of the limb-wise equalities.
+ * 
+ * @param a first integer
+ * @param b second integer (same base and number of limbs)
+ * @param cc cryptographical context
+ * @return integerComparisons containing ==, >, >=, < and <=
+ */
+template <class Tools>
+integerComparisons compareIntegers(encryptedInteger a, encryptedInteger b, Tools cc) {
+    CountedOperation counted("compareIntegers", a.limbs);
+    uint n = a.limbs.size();
+    std::vector<Ciphertext<DCRTPoly>> greater(n);
+    std::vector<Ciphertext<DCRTPoly>> equals(n);
+    for (uint i = 0; i < n; i++) {
+        greater[i] = gt(a.limbs[i], b.limbs[i], cc);
+        equals[i] = equal(a.limbs[i], b.limbs[i], cc);
+    }
+    limbPrefix(greater, equals, 0, n, true, cc);
+
+    integerComparisons results;
+    Plaintext one = encodeCoefficient(1, cc);
+    results.gt = counted.output(greater[n-1]);
+    results.eq = counted.output(equals[n-1]);
+    results.gteq = evalAdd(cc.cryptoContext, results.gt, results.eq);
+    results.lteq = evalAdd(cc.cryptoContext, evalNegate(cc.cryptoContext, results.gt), one);
+    results.lt = evalSub(cc.cryptoContext, results.lteq, results.eq);
+    return results;
+}
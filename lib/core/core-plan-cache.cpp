@@ -0,0 +1,283 @@
+// Created on February 13 2023
+// By Julen Bernabe Rodriguez <julen.bernabe@tecnalia.com>
+// Copyright (c) 2023 Tecnalia Research & Innovation
+
+/*
+ * Evaluation core: interpolation plan cache
+ */
+
+#include "scheme/bgvrns/cryptocontext-bgvrns.h"
+#include "gen-cryptocontext.h"
+
+#include <iostream>
+#include <fstream>
+#include <limits>
+#include <iterator>
+#include <random>
+#include <map>
+#include <list>
+#include <mutex>
+#include <functional>
+#include <sstream>
+#include <cstdio>
+
+using namespace lbcrypto;
+
+/**
+ * @brief Encoded plan kept in the plan cache
+ * 
+ * @param plan plan with the encoded coefficients
+ * @param bytes estimated bytes of its encoded coefficients
+ * @param use position of the plan in the list of recently used plans
+ */
+struct CachedPlan {
+    interpolationPlan plan;
+    size_t bytes;
+    std::list<std::string>::iterator use;
+};
+
+/**
+ * @brief Cache of interpolation plans shared by every thread of the process
+ * 
+ * Each context (e.g. each client of the server) has its own encoded plans, so they are bounded: once their bytes
+ * exceed the budget, the least recently used plans are dropped (and encoded again if they are needed later).
+ * 
+ * @param mutex protects the whole cache
+ * @param coefficients coefficients of each polynomial, keyed by "function/p" (persisted on disk)
+ * @param plans plans with the encoded coefficients, keyed by "function/p/ring parameters" (only valid in this process)
+ * @param recentPlans keys of the encoded plans, most recently used first
+ * @param planBytes estimated bytes of the encoded plans
+ * @param planBudget bytes the encoded plans may take
+ * @param modified true if there are coefficients that are not yet on disk
+ */
+struct PlanCache {
+    std::mutex mutex;
+    std::map<std::string, std::vector<int64_t>> coefficients;
+    std::map<std::string, CachedPlan> plans;
+    std::list<std::string> recentPlans;
+    size_t planBytes = 0;
+    size_t planBudget = 256ull << 20;
+    bool modified = false;
+};
+
+PlanCache planCache;
+
+// File used by the programs to persist the plan cache between runs
+const std::string planCachePath = "interpolation-plans.txt";
+
+/**
+ * @brief Describe the ring parameters the plaintexts are encoded for
+ * 
+ * Contexts of different clients may share the ring dimension and number of towers with different moduli, and
+ * their plaintexts must not be mixed, so every tower modulus is part of the key.
+ * 
+ * @param cc cryptographical context
+ * @return std::string with the ring dimension, tower moduli and batch size
+ */
+template <class Tools>
+std::string ringParametersKey(Tools cc) {
+    std::ostringstream key;
+    key << "n" << cc.cryptoContext->GetRingDimension();
+    const auto &towers = cc.cryptoContext->GetElementParams()->GetParams();
+    key << "/towers" << towers.size();
+    for (size_t i = 0; i < towers.size(); i++) {
+        key << "/" << towers[i]->GetModulus();
+    }
+    key << "/batch" << cc.cryptoContext->GetEncodingParams()->GetBatchSize();
+    return key.str();
+}
+
+/*
+ * Drops the least recently used encoded plans until they fit in the budget. The caller holds the mutex.
+ */
+void evictPlans() {
+    while (planCache.planBytes > planCache.planBudget && !planCache.recentPlans.empty()) {
+        auto plan = planCache.plans.find(planCache.recentPlans.back());
+        planCache.planBytes -= plan->second.bytes;
+        planCache.plans.erase(plan);
+        planCache.recentPlans.pop_back();
+    }
+}
+
+/*
+ * Sets the bytes the encoded plans may take (plans in use by running evaluations stay alive until they finish).
+ */
+void setPlanCacheBudget(size_t bytes) {
+    std::lock_guard<std::mutex> lock(planCache.mutex);
+    planCache.planBudget = bytes;
+    evictPlans();
+}
+
+/*
+ * Drops the encoded plans of a context, e.g. once the last session using it ends.
+ */
+template <class Tools>
+void dropInterpolationPlans(Tools cc) {
+    std::string suffix = "/" + ringParametersKey(cc);
+    std::lock_guard<std::mutex> lock(planCache.mutex);
+    for (auto plan = planCache.plans.begin(); plan != planCache.plans.end();) {
+        const std::string &key = plan->first;
+        if (key.size() >= suffix.size() && key.compare(key.size() - suffix.size(), suffix.size(), suffix) == 0) {
+            planCache.planBytes -= plan->second.bytes;
+            planCache.recentPlans.erase(plan->second.use);
+            plan = planCache.plans.erase(plan);
+        } else {
+            ++plan;
+        }
+    }
+}
+
+/**
+ * @brief Get the coefficients of the interpolation polynomial of a function, interpolating it only if it is not cached
+ * 
+ * @param function name of the function (e.g. "sign" or "division/7")
+ * @param points generator of the interpolation points of the function for some p
+ * @param p plaintext modulus
+ * @return std::vector<int64_t> containing the coefficients mod p
+ */
+std::vector<int64_t> getInterpolationCoefficients(std::string function, std::function<interpolationPoints(int)> points, int p) {
+    std::string key = function + "/" + std::to_string(p);
+    {
+        std::lock_guard<std::mutex> lock(planCache.mutex);
+        auto cached = planCache.coefficients.find(key);
+        if (cached != planCache.coefficients.end()) {
+            return cached->second;
+        }
+    }
+
+    // Interpolate outside the lock, so other threads can keep using the cache
+    std::vector<int64_t> coefficients = getLagrangePoly(points(p), p);
+
+    std::lock_guard<std::mutex> lock(planCache.mutex);
+    if (planCache.coefficients.insert({key, coefficients}).second) {
+        planCache.modified = true;
+    }
+    return coefficients;
+}
+
+/**
+ * @brief Get the interpolation plan of a function, interpolating and encoding it only if it is not cached
+ * 
+ * @param function name of the function (e.g. "sign" or "division/7")
+ * @param points generator of the interpolation points of the function for some p
+ * @param cc cryptographical context
+ * @return interpolationPlan containing the coefficients and their encodings
+ */
+template <class Tools>
+interpolationPlan getInterpolationPlan(std::string function, std::function<interpolationPoints(int)> points, Tools cc) {
+    int p = cc.cryptoContext->GetCryptoParameters()->GetPlaintextModulus();
+    std::string encodedKey = function + "/" + std::to_string(p) + "/" + ringParametersKey(cc);
+    {
+        std::lock_guard<std::mutex> lock(planCache.mutex);
+        auto plan = planCache.plans.find(encodedKey);
+        if (plan != planCache.plans.end()) {
+            planCache.recentPlans.splice(planCache.recentPlans.begin(), planCache.recentPlans, plan->second.use);
+            return plan->second.plan;
+        }
+    }
+
+    // Encode outside the lock, so other threads can keep using the cache
+    interpolationPlan plan = makeInterpolationPlan(getInterpolationCoefficients(function, points, p), cc);
+    size_t encodedBytes = (size_t) cc.cryptoContext->GetRingDimension() * cc.cryptoContext->GetElementParams()->GetParams().size() * sizeof(uint64_t);
+    size_t bytes = 0;
+    for (uint i = 0; i < plan.encoded.size(); i++) {
+        bytes += plan.encoded[i] ? encodedBytes : 0;
+    }
+
+    std::lock_guard<std::mutex> lock(planCache.mutex);
+    if (planCache.plans.find(encodedKey) == planCache.plans.end()) {
+        planCache.recentPlans.push_front(encodedKey);
+        planCache.plans.insert({encodedKey, {plan, bytes, planCache.recentPlans.begin()}});
+        planCache.planBytes += bytes;
+        evictPlans();
+    }
+    return plan;
+}
+
+/**
+ * @brief Read one stored polynomial: its key ("function/p"), number of coefficients and the coefficients
+ * 
+ * @param line line of the file
+ * @param key key of the polynomial
+ * @param coefficients coefficients of the polynomial
+ * @return true if the line is well formed: 1 to p coefficients, each of them in [0, p)
+ */
+bool parsePlanLine(const std::string &line, std::string &key, std::vector<int64_t> &coefficients) {
+    std::istringstream fields(line);
+    size_t size;
+    if (!(fields >> key >> size)) {
+        return false;
+    }
+    size_t slash = key.rfind('/');
+    int64_t p;
+    std::istringstream modulus(slash == std::string::npos ? "" : key.substr(slash + 1));
+    if (!(modulus >> p) || !modulus.eof() || p < 2 || size < 1 || size > (uint64_t) p) {
+        return false;
+    }
+    coefficients.resize(size);
+    for (size_t i = 0; i < size; i++) {
+        if (!(fields >> coefficients[i]) || coefficients[i] < 0 || coefficients[i] >= p) {
+            return false;
+        }
+    }
+    std::string extra;
+    return !(fields >> extra);
+}
+
+/**
+ * @brief Load the coefficients stored on disk into the plan cache
+ * 
+ * Each line of the file contains the key of a polynomial, its number of coefficients and the coefficients.
+ * Malformed lines are skipped, so a corrupt file only costs the interpolations it no longer provides.
+ * 
+ * @param path file containing the stored plans
+ * @return true if the file could be read
+ */
+bool loadPlanCache(std::string path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(planCache.mutex);
+    std::string line;
+    while (std::getline(file, line)) {
+        std::string key;
+        std::vector<int64_t> coefficients;
+        if (parsePlanLine(line, key, coefficients)) {
+            planCache.coefficients[key] = coefficients;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Store the coefficients of the plan cache on disk (only if new plans were computed)
+ * 
+ * @param path file where the plans are stored
+ * @return true if the file is up to date
+ */
+bool savePlanCache(std::string path) {
+    std::lock_guard<std::mutex> lock(planCache.mutex);
+    if (!planCache.modified) {
+        return true;
+    }
+    // Write to a temporary file first, so a concurrent reader never sees a partial store
+    std::string tmpPath = path + ".tmp";
+    std::ofstream file(tmpPath);
+    if (!file.is_open()) {
+        return false;
+    }
+    for (auto &entry : planCache.coefficients) {
+        file << entry.first << " " << entry.second.size();
+        for (int64_t coefficient : entry.second) {
+            file << " " << coefficient;
+        }
+        file << "\n";
+    }
+    file.close();
+    if (!file || std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        return false;
+    }
+    planCache.modified = false;
+    return true;
+}
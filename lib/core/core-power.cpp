@@ -0,0 +1,287 @@
+// Created on February 13 2023
+// By Julen Bernabe Rodriguez <julen.bernabe@tecnalia.com>
+// Copyright (c) 2023 Tecnalia Research & Innovation
+
+/*
+ * Evaluation core: powers
+ */
+
+#include "scheme/bgvrns/cryptocontext-bgvrns.h"
+#include "gen-cryptocontext.h"
+
+#include <iostream>
+#include <fstream>
+#include <limits>
+#include <iterator>
+#include <random>
+#include <time.h>
+#include <functional>
+
+using namespace lbcrypto;
+
+/**
+ * @brief Compute vector of ciphertexts containing: {c^{2^0}, c^{2^1}, c^{2^2}, ..., c^{2^{bit-length}}
+ * 
+ * @param ciphertext the ciphertext to use as input
+ * @param bitLength bit length of p
+ * @param cc cryptographical context
+ * @return std::vector<Ciphertext<DCRTPoly>> containing {c^{2^0}, c^{2^1}, c^{2^2}, ..., c^{2^{bit-length}}
+ */
+template <class Tools>
+std::vector<Ciphertext<DCRTPoly>> powersOfTwo(Ciphertext<DCRTPoly> ciphertext, uint bitLength, Tools cc) {
+    // Initialize vector of ciphertexts containing: {c^{2^0}, c^{2^1}, c^{2^2}, ..., c^{2^{bit-length}}
+    std::vector<Ciphertext<DCRTPoly>> preComputedValues;
+    
+    // Add c^{2^0} = c to preComputedValues
+    preComputedValues.push_back(ciphertext);
+
+    // Fill preComputedValues with remaining powers
+    for (uint i = 1; i <= bitLength; i++) {
+        preComputedValues.push_back(evalMult(cc.cryptoContext, preComputedValues[i-1], preComputedValues[i-1]));
+    }
+    return preComputedValues;
+}
+
+/**
+ * @brief Memoized powers of a ciphertext c
+ * 
+ * @param memo memo[i-1] contains c^i once it has been computed (nullptr otherwise)
+ */
+struct PowerLadder {
+    std::vector<Ciphertext<DCRTPoly>> memo;
+};
+
+typedef struct PowerLadder powerLadder;
+
+/**
+ * @brief Initialize the power ladder of a ciphertext
+ * 
+ * @param ciphertext the ciphertext c
+ * @return powerLadder containing only c^1
+ */
+powerLadder initPowerLadder(Ciphertext<DCRTPoly> ciphertext) {
+    powerLadder ladder;
+    ladder.memo.push_back(ciphertext);
+    return ladder;
+}
+
+/**
+ * @brief Exponent of the first factor used to compute c^n in the power ladder
+ * 
+ * c^{2^d} is the square of c^{2^{d-1}}, and any other c^n is c^{2^d} x c^{n - 2^d} with 2^d the largest
+ * power of two below n. Both factors have lower depth, so c^n has depth ceil(log2(n)), and the second
+ * factor has the parity of n: odd (or even) powers only need odd (or even) powers and powers of two.
+ * 
+ * @param n exponent (n >= 2)
+ * @return uint exponent of the first factor (the second one is n minus it)
+ */
+uint ladderSplit(uint n) {
+    uint powerOfTwo = 1;
+    while (2 * powerOfTwo < n) {
+        powerOfTwo *= 2;
+    }
+    return powerOfTwo;
+}
+
+/**
+ * @brief Get c^n from the power ladder, computing it (and the powers it needs) if not already there
+ * 
+ * @param ladder power ladder of c
+ * @param n exponent (n >= 1)
+ * @param cc cryptographical context
+ * @return Ciphertext<DCRTPoly> containing c^n
+ */
+template <class Tools>
+Ciphertext<DCRTPoly> getPower(powerLadder &ladder, uint n, Tools cc) {
+    if (n > ladder.memo.size()) {
+        ladder.memo.resize(n);
+    }
+    if (!ladder.memo[n-1]) {
+        uint first = ladderSplit(n);
+        Ciphertext<DCRTPoly> low = getPower(ladder, first, cc);
+        Ciphertext<DCRTPoly> high = getPower(ladder, n - first, cc);
+        ladder.memo[n-1] = evalMult(cc.cryptoContext, low, high);
+    }
+    return ladder.memo[n-1];
+}
+
+/**
+ * @brief Add some powers to the power ladder, together with the powers they are computed from
+ * 
+ * Powers with the same depth (exponents in (2^{d-1}, 2^d]) only depend on powers of lower depth,
+ * so each depth is computed concurrently when evalThreads > 1.
+ * 
+ * @param ladder power ladder of c
+ * @param exponents exponents of the powers to be computed (>= 1)
+ * @param cc cryptographical context
+ */
+template <class Tools>
+void computePowers(powerLadder &ladder, const std::vector<uint> &exponents, Tools cc) {
+    uint max = 0;
+    for (uint i = 0; i < exponents.size(); i++) {
+        max = std::max(max, exponents[i]);
+    }
+    if (max > ladder.memo.size()) {
+        ladder.memo.resize(max);
+    }
+
+    // Mark the missing powers and the missing powers they depend on
+    std::vector<bool> missing(max + 1, false);
+    std::vector<uint> pending = exponents;
+    while (!pending.empty()) {
+        uint n = pending.back();
+        pending.pop_back();
+        if (missing[n] || ladder.memo[n-1]) {
+            continue;
+        }
+        missing[n] = true;
+        pending.push_back(ladderSplit(n));
+        pending.push_back(n - ladderSplit(n));
+    }
+
+    for (uint top = 2; top / 2 < max; top *= 2) {
+        std::vector<uint> level;
+        for (uint n = top / 2 + 1; n <= std::min(top, max); n++) {
+            if (missing[n]) {
+                level.push_back(n);
+            }
+        }
+        #pragma omp parallel for num_threads(evalThreads) copyin(activeFrame) schedule(dynamic) if(evalThreads > 1)
+        for (int i = 0; i < (int) level.size(); i++) {
+            uint n = level[i];
+            uint first = ladderSplit(n);
+            ladder.memo[n-1] = evalMult(cc.cryptoContext, ladder.memo[first-1], ladder.memo[n-first-1]);
+        }
+    }
+}
+
+/**
+ * @brief Fill the power ladder with every power {c, c^2, ..., c^max}
+ * 
+ * @param ladder power ladder of c
+ * @param max highest exponent
+ * @param cc cryptographical context
+ */
+template <class Tools>
+void fillPowerLadder(powerLadder &ladder, uint max, Tools cc) {
+    std::vector<uint> exponents;
+    for (uint n = 1; n <= max; n++) {
+        exponents.push_back(n);
+    }
+    computePowers(ladder, exponents, cc);
+}
+
+/**
+ * @brief Compute array of powers of ciphertexts: {c, c^2, ..., c^{p-1}}
+ * 
+ * @param ciphertext the ciphertext to use as input
+ * @param cc cryptographical context
+ * @return std::vector<Ciphertext<DCRTPoly>> containing {c, c^2, ..., c^{p-1}}
+ */
+template <class Tools>
+std::vector<Ciphertext<DCRTPoly>> powers(Ciphertext<DCRTPoly> ciphertext, Tools cc) {
+    CountedOperation counted("powers", {ciphertext});
+    uint max = (cc.cryptoContext->GetCryptoParameters()->GetPlaintextModulus()) - 1;
+
+    // Every c^i is derived from two powers already in the ladder (p-2 multiplications overall)
+    powerLadder ladder = initPowerLadder(ciphertext);
+    fillPowerLadder(ladder, max, cc);
+    counted.output(ladder.memo.back());
+    return ladder.memo;
+}
+
+/*
+ * Visits c^m, then depth-first every power of the ladder computed from it: c^{m + 2^d} = c^{2^d} x c^m
+ * for each 2^d >= m (see ladderSplit). Only the powers on the current path are kept alive.
+ */
+template <class Tools>
+void streamPowersFrom(uint m, Ciphertext<DCRTPoly> power, uint max, const std::vector<Ciphertext<DCRTPoly>> &twos,
+                      const std::function<void(uint, const Ciphertext<DCRTPoly>&)> &visit, Tools cc) {
+    visit(m, power);
+    uint d = 0;
+    while ((1u << d) < m) {
+        d++;
+    }
+    for (; d < twos.size() && m + (1u << d) <= max; d++) {
+        uint n = m + (1u << d);
+        // c^{2^{d+1}} (m = 2^d) is already among the powers of two
+        Ciphertext<DCRTPoly> next = n == (2u << d) ? twos[d+1] : evalMult(cc.cryptoContext, twos[d], power);
+        streamPowersFrom(n, next, max, twos, visit, cc);
+    }
+}
+
+/**
+ * @brief Compute every power {c, c^2, ..., c^max} one at a time, handing each one to visit as soon as it is ready
+ * 
+ * The powers are the ones of the power ladder (same products and depth, p-2 multiplications for max = p-1), but
+ * they are produced depth-first: besides the powers of two, only the powers on the current path of the ladder are
+ * alive, so at most 2 log2(max) ciphertexts are held at once instead of max.
+ * 
+ * @param ciphertext the ciphertext c
+ * @param max highest exponent
+ * @param visit called with (n, c^n) for every n in [1, max], in depth-first order of the ladder
+ * @param cc cryptographical context
+ */
+template <class Tools>
+void streamPowers(Ciphertext<DCRTPoly> ciphertext, uint max, std::function<void(uint, const Ciphertext<DCRTPoly>&)> visit, Tools cc) {
+    if (max == 0) {
+        return;
+    }
+    uint bitLength = 0;
+    while ((2u << bitLength) <= max) {
+        bitLength++;
+    }
+    std::vector<Ciphertext<DCRTPoly>> twos = powersOfTwo(ciphertext, bitLength, cc);
+    streamPowersFrom(1, ciphertext, max, twos, visit, cc);
+}
+
+/*
+ * Task graphs of ciphertexts: node operations receive the values of their inputs.
+ */
+typedef TaskGraph<Ciphertext<DCRTPoly>> ciphertextGraph;
+typedef std::vector<Ciphertext<DCRTPoly>> nodeValues;
+
+const size_t noNode = std::numeric_limits<size_t>::max();
+
+/*
+ * Adds the node of c^n (and of the powers it is computed from) if not already in nodes.
+ */
+template <class Tools>
+size_t addPowerNode(ciphertextGraph &graph, std::vector<size_t> &nodes, uint n, Tools cc) {
+    if (nodes[n-1] == noNode) {
+        uint first = ladderSplit(n);
+        size_t low = addPowerNode(graph, nodes, first, cc);
+        size_t high = addPowerNode(graph, nodes, n - first, cc);
+        CryptoContext<DCRTPoly> context = cc.cryptoContext;
+        nodes[n-1] = graph.add([context](const nodeValues &factors) {
+            return evalMult(context, factors[0], factors[1]);
+        }, {low, high});
+    }
+    return nodes[n-1];
+}
+
+/**
+ * @brief Add the nodes of some powers of c to a task graph, together with the powers they are computed from
+ * 
+ * Each power is the product of the same two factors as in getPower, so it runs as soon as both are ready
+ * (there is no barrier between depths as in computePowers), and it is freed once its consumers are done.
+ * 
+ * @param graph task graph
+ * @param base node of c
+ * @param exponents exponents of the powers to be computed (>= 1)
+ * @param cc cryptographical context
+ * @return std::vector<size_t> node of c^n at position n-1 (noNode for the powers that are not needed)
+ */
+template <class Tools>
+std::vector<size_t> addPowerNodes(ciphertextGraph &graph, size_t base, const std::vector<uint> &exponents, Tools cc) {
+    uint max = 1;
+    for (uint i = 0; i < exponents.size(); i++) {
+        max = std::max(max, exponents[i]);
+    }
+    std::vector<size_t> nodes(max, noNode);
+    nodes[0] = base;
+    for (uint i = 0; i < exponents.size(); i++) {
+        addPowerNode(graph, nodes, exponents[i], cc);
+    }
+    return nodes;
+}
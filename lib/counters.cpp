@@ -0,0 +1,456 @@
+// Created on February 13 2023
+// By Julen Bernabe Rodriguez <julen.bernabe@tecnalia.com>
+// Copyright (c) 2023 Tecnalia Research & Innovation
+
+/*
+ * Counters of the homomorphic operations run by each public operation, and of the memory held by their ciphertexts
+ */
+
+#include "scheme/bgvrns/cryptocontext-bgvrns.h"
+#include "gen-cryptocontext.h"
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <limits>
+
+using namespace lbcrypto;
+
+enum CountedEvent {
+    COUNT_CALLS,                // calls of the public operation
+    COUNT_EVAL_MULT,            // EvalMult, EvalMultNoRelin (by ciphertexts and by plaintexts)
+    COUNT_EVAL_ADD,             // EvalAdd, EvalSub, EvalNegate
+    COUNT_RELINEARIZATIONS,     // key switches: EvalMult of two ciphertexts, Relinearize
+    COUNT_ENCRYPTIONS,          // fresh Encrypt calls
+    COUNT_LEVELS_CONSUMED,      // levels consumed, added over the calls
+    COUNT_EVENTS
+};
+
+/**
+ * @brief Counters of a public operation (sign, max, intPrivDivision...), including the operations it calls
+ * 
+ * @param calls number of calls
+ * @param evalMult multiplications
+ * @param evalAdd additions, subtractions and negations
+ * @param relinearizations key switches
+ * @param encryptions fresh encryptions
+ * @param levelsConsumed levels consumed from the inputs to the outputs, added over the calls
+ * @param remainingLevels fewest levels left in an output
+ * @param remainingModulusBits bits of the smallest ciphertext modulus left in an output: the noise budget left
+ *                             is below it (the noise itself can only be measured with the secret key)
+ * @param peakBytes most bytes held at once by the ciphertexts created during a call
+ */
+struct OperationCounts {
+    uint64_t calls = 0;
+    uint64_t evalMult = 0;
+    uint64_t evalAdd = 0;
+    uint64_t relinearizations = 0;
+    uint64_t encryptions = 0;
+    uint64_t levelsConsumed = 0;
+    uint64_t remainingLevels = 0;
+    uint64_t remainingModulusBits = 0;
+    uint64_t peakBytes = 0;
+};
+
+typedef struct OperationCounts operationCounts;
+
+/*
+ * Counters of a public operation while it is being updated (by several threads when evalThreads > 1).
+ */
+struct OperationTally {
+    OperationTally() {
+        reset();
+    }
+
+    void reset() {
+        for (int i = 0; i < COUNT_EVENTS; i++) {
+            events[i] = 0;
+        }
+        remainingLevels = std::numeric_limits<uint64_t>::max();
+        remainingModulusBits = std::numeric_limits<uint64_t>::max();
+        peakBytes = 0;
+    }
+
+    std::atomic<uint64_t> events[COUNT_EVENTS];
+    std::atomic<uint64_t> remainingLevels;
+    std::atomic<uint64_t> remainingModulusBits;
+    std::atomic<uint64_t> peakBytes;
+};
+
+std::map<std::string, std::unique_ptr<OperationTally>> operationTallies;
+std::mutex operationTalliesMutex;
+
+OperationTally *operationTally(const std::string &name) {
+    std::lock_guard<std::mutex> lock(operationTalliesMutex);
+    std::unique_ptr<OperationTally> &tally = operationTallies[name];
+    if (!tally) {
+        tally.reset(new OperationTally());
+    }
+    return tally.get();
+}
+
+/*
+ * Bytes held by the ciphertexts created during one call of a public operation that are still alive.
+ */
+struct CallMemory {
+    std::atomic<uint64_t> live{0};
+    std::atomic<uint64_t> peak{0};
+};
+
+/*
+ * Public operations running in this thread, innermost first. The parallel regions of the library copy it into
+ * their threads (copyin), so the work they share out is counted as well.
+ */
+struct CountingFrame {
+    OperationTally *tally;          // nullptr if the operation is already running further out
+    const CountingFrame *parent;
+    std::shared_ptr<CallMemory> memory;
+};
+
+// Clang rejects threadprivate on thread_local variables; threadprivate alone is per thread (also for std::thread)
+#ifdef _OPENMP
+static const CountingFrame *activeFrame = nullptr;
+#pragma omp threadprivate(activeFrame)
+#else
+static thread_local const CountingFrame *activeFrame = nullptr;
+#endif
+
+/*
+ * Adds n events to every public operation running in this thread.
+ */
+void countEvent(CountedEvent event, uint64_t n = 1) {
+    for (const CountingFrame *frame = activeFrame; frame; frame = frame->parent) {
+        if (frame->tally) {
+            frame->tally->events[event].fetch_add(n, std::memory_order_relaxed);
+        }
+    }
+}
+
+void keepMinimum(std::atomic<uint64_t> &minimum, uint64_t value) {
+    uint64_t current = minimum.load();
+    while (value < current && !minimum.compare_exchange_weak(current, value)) {}
+}
+
+void keepMaximum(std::atomic<uint64_t> &maximum, uint64_t value) {
+    uint64_t current = maximum.load();
+    while (value > current && !maximum.compare_exchange_weak(current, value)) {}
+}
+
+/*
+ * Ciphertexts created by the library that are still alive, and the bytes their DCRTPoly elements hold.
+ */
+std::atomic<uint64_t> liveCiphertexts{0};
+std::atomic<uint64_t> liveCiphertextBytes{0};
+std::atomic<uint64_t> peakCiphertextBytes{0};
+
+/*
+ * Bytes held by the DCRTPoly elements of a ciphertext: one 64-bit word per coefficient of each tower.
+ */
+uint64_t ciphertextBytes(const Ciphertext<DCRTPoly> &c) {
+    uint64_t bytes = 0;
+    const std::vector<DCRTPoly> &elements = c->GetElements();
+    for (size_t i = 0; i < elements.size(); i++) {
+        bytes += (uint64_t) elements[i].GetNumOfElements() * elements[i].GetRingDimension() * sizeof(uint64_t);
+    }
+    return bytes;
+}
+
+/*
+ * Owner of a tracked ciphertext: the memory it holds is accounted for until its last copy is dropped.
+ */
+class TrackedCiphertext {
+public:
+    TrackedCiphertext(Ciphertext<DCRTPoly> c) : ciphertext(c), bytes(ciphertextBytes(c)) {
+        liveCiphertexts++;
+        keepMaximum(peakCiphertextBytes, liveCiphertextBytes += bytes);
+        for (const CountingFrame *frame = activeFrame; frame; frame = frame->parent) {
+            if (frame->tally) {
+                keepMaximum(frame->memory->peak, frame->memory->live += bytes);
+                calls.push_back(frame->memory);
+            }
+        }
+    }
+
+    ~TrackedCiphertext() {
+        liveCiphertexts--;
+        liveCiphertextBytes -= bytes;
+        for (size_t i = 0; i < calls.size(); i++) {
+            calls[i]->live -= bytes;
+        }
+    }
+
+    Ciphertext<DCRTPoly> ciphertext;
+
+private:
+    uint64_t bytes;
+    std::vector<std::shared_ptr<CallMemory>> calls;
+};
+
+/*
+ * Returns a copy of c that shares the same ciphertext and is accounted for while alive.
+ */
+Ciphertext<DCRTPoly> trackCiphertext(Ciphertext<DCRTPoly> c) {
+    std::shared_ptr<TrackedCiphertext> owner = std::make_shared<TrackedCiphertext>(c);
+    return Ciphertext<DCRTPoly>(owner, owner->ciphertext.get());
+}
+
+/*
+ * Counts a public operation while it is in scope:
+ *     CountedOperation counted("sign", {c});
+ *     ...
+ *     return counted.output(result);
+ * The operations it calls are counted for it too, once (also when it calls itself).
+ */
+class CountedOperation {
+public:
+    CountedOperation(const std::string &name, const std::vector<Ciphertext<DCRTPoly>> &inputs) {
+        OperationTally *tally = operationTally(name);
+        for (const CountingFrame *frame = activeFrame; frame && tally; frame = frame->parent) {
+            if (frame->tally == tally) {
+                tally = nullptr;
+            }
+        }
+        frame = {tally, activeFrame, tally ? std::make_shared<CallMemory>() : nullptr};
+        activeFrame = &frame;
+        if (tally) {
+            tally->events[COUNT_CALLS]++;
+        }
+        for (const Ciphertext<DCRTPoly> &input : inputs) {
+            inputLevel = std::max(inputLevel, (uint64_t) input->GetLevel());
+        }
+    }
+
+    ~CountedOperation() {
+        if (frame.tally) {
+            frame.tally->events[COUNT_LEVELS_CONSUMED] += levelsConsumed;
+            keepMaximum(frame.tally->peakBytes, frame.memory->peak);
+        }
+        activeFrame = frame.parent;
+    }
+
+    // Records the levels consumed and left by an output of the operation
+    Ciphertext<DCRTPoly> output(Ciphertext<DCRTPoly> c) {
+        if (frame.tally) {
+            uint64_t level = c->GetLevel();
+            levelsConsumed = std::max(levelsConsumed, level > inputLevel ? level - inputLevel : 0);
+            const DCRTPoly &element = c->GetElements()[0];
+            keepMinimum(frame.tally->remainingLevels, element.GetNumOfElements() - 1);
+            keepMinimum(frame.tally->remainingModulusBits, element.GetModulus().GetMSB());
+        }
+        return c;
+    }
+
+private:
+    CountingFrame frame;
+    uint64_t inputLevel = 0;
+    uint64_t levelsConsumed = 0;
+};
+
+/**
+ * @brief Counters of every public operation called so far
+ * 
+ * @return std::map<std::string, operationCounts> counters by operation name
+ */
+std::map<std::string, operationCounts> getOperationCounts() {
+    std::lock_guard<std::mutex> lock(operationTalliesMutex);
+    std::map<std::string, operationCounts> counts;
+    for (auto &entry : operationTallies) {
+        const OperationTally &tally = *entry.second;
+        if (tally.events[COUNT_CALLS] == 0) {
+            continue;
+        }
+        operationCounts &count = counts[entry.first];
+        count.calls = tally.events[COUNT_CALLS];
+        count.evalMult = tally.events[COUNT_EVAL_MULT];
+        count.evalAdd = tally.events[COUNT_EVAL_ADD];
+        count.relinearizations = tally.events[COUNT_RELINEARIZATIONS];
+        count.encryptions = tally.events[COUNT_ENCRYPTIONS];
+        count.levelsConsumed = tally.events[COUNT_LEVELS_CONSUMED];
+        count.remainingLevels = tally.remainingLevels == std::numeric_limits<uint64_t>::max() ? 0 : tally.remainingLevels.load();
+        count.remainingModulusBits = tally.remainingModulusBits == std::numeric_limits<uint64_t>::max() ? 0 : tally.remainingModulusBits.load();
+        count.peakBytes = tally.peakBytes;
+    }
+    return counts;
+}
+
+/*
+ * Sets every counter back to zero.
+ */
+void resetOperationCounts() {
+    std::lock_guard<std::mutex> lock(operationTalliesMutex);
+    for (auto &entry : operationTallies) {
+        entry.second->reset();
+    }
+}
+
+/**
+ * @brief Write the counters of every public operation called so far, per call
+ * 
+ * @param out stream where the counters are written
+ */
+void dumpOperationCounts(std::ostream &out) {
+    std::map<std::string, operationCounts> counts = getOperationCounts();
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << std::left << std::setw(24) << "operation" << std::right << std::setw(8) << "calls" << std::setw(12) << "EvalMult"
+        << std::setw(12) << "EvalAdd" << std::setw(12) << "relin" << std::setw(12) << "Encrypt" << std::setw(10) << "levels"
+        << std::setw(12) << "levels left" << std::setw(12) << "bits left" << std::setw(12) << "peak MiB" << std::endl;
+    out << std::fixed << std::setprecision(1);
+    for (auto &entry : counts) {
+        const operationCounts &count = entry.second;
+        double calls = count.calls;
+        out << std::left << std::setw(24) << entry.first << std::right << std::setw(8) << count.calls
+            << std::setw(12) << count.evalMult / calls << std::setw(12) << count.evalAdd / calls
+            << std::setw(12) << count.relinearizations / calls << std::setw(12) << count.encryptions / calls
+            << std::setw(10) << count.levelsConsumed / calls << std::setw(12) << count.remainingLevels
+            << std::setw(12) << count.remainingModulusBits << std::setw(12) << count.peakBytes / 1048576.0 << std::endl;
+    }
+    out << "live ciphertexts: " << liveCiphertexts << " (" << liveCiphertextBytes / 1048576.0 << " MiB, peak "
+        << peakCiphertextBytes / 1048576.0 << " MiB)" << std::endl;
+    out.flags(flags);
+    out.precision(precision);
+}
+
+/**
+ * @brief Memory held by the ciphertexts created by the library
+ * 
+ * @param ciphertexts ciphertexts alive
+ * @param bytes bytes held by their DCRTPoly elements
+ * @param peakBytes most bytes held at once so far
+ */
+struct MemoryUsage {
+    uint64_t ciphertexts;
+    uint64_t bytes;
+    uint64_t peakBytes;
+};
+
+typedef struct MemoryUsage memoryUsage;
+
+memoryUsage getMemoryUsage() {
+    return {liveCiphertexts, liveCiphertextBytes, peakCiphertextBytes};
+}
+
+/*
+ * Memory budget of the evaluations, in bytes (0 for no budget). Evaluators reserve the bytes they expect to
+ * hold before they start (MemoryReservation), and wait while their reservation does not fit in the budget.
+ */
+uint64_t memoryBudgetBytes = 0;
+uint64_t reservedBytes = 0;
+std::mutex memoryBudgetMutex;
+std::condition_variable memoryReleased;
+
+void setMemoryBudget(uint64_t bytes) {
+    std::lock_guard<std::mutex> lock(memoryBudgetMutex);
+    memoryBudgetBytes = bytes;
+    memoryReleased.notify_all();
+}
+
+uint64_t memoryBudget() {
+    std::lock_guard<std::mutex> lock(memoryBudgetMutex);
+    return memoryBudgetBytes;
+}
+
+/*
+ * Whether bytes more fit in the budget next to the current reservations.
+ */
+bool fitsMemoryBudget(uint64_t bytes) {
+    std::lock_guard<std::mutex> lock(memoryBudgetMutex);
+    return memoryBudgetBytes == 0 || reservedBytes + bytes <= memoryBudgetBytes;
+}
+
+/*
+ * Reservation of memory for an evaluation while in scope. It waits until the bytes fit in the budget, or until
+ * no other reservation is left (so an evaluation larger than the whole budget runs alone instead of never).
+ */
+class MemoryReservation {
+public:
+    explicit MemoryReservation(uint64_t bytes) : bytes(bytes) {
+        std::unique_lock<std::mutex> lock(memoryBudgetMutex);
+        memoryReleased.wait(lock, [bytes] {
+            return memoryBudgetBytes == 0 || reservedBytes == 0 || reservedBytes + bytes <= memoryBudgetBytes;
+        });
+        reservedBytes += bytes;
+    }
+
+    ~MemoryReservation() {
+        {
+            std::lock_guard<std::mutex> lock(memoryBudgetMutex);
+            reservedBytes -= bytes;
+        }
+        memoryReleased.notify_all();
+    }
+
+    MemoryReservation(const MemoryReservation &) = delete;
+    MemoryReservation &operator=(const MemoryReservation &) = delete;
+
+private:
+    uint64_t bytes;
+};
+
+/*
+ * Peak bytes of a call of a public operation, as measured so far, or fallback if it has not been called yet.
+ */
+uint64_t expectedPeakBytes(const std::string &operation, uint64_t fallback) {
+    uint64_t peak = operationTally(operation)->peakBytes;
+    return peak ? peak : fallback;
+}
+
+/*
+ * Calls into CryptoContext made by the library, counted for the public operations running in this thread.
+ */
+Ciphertext<DCRTPoly> evalMult(const CryptoContext<DCRTPoly> &context, const Ciphertext<DCRTPoly> &a, const Ciphertext<DCRTPoly> &b) {
+    countEvent(COUNT_EVAL_MULT);
+    countEvent(COUNT_RELINEARIZATIONS);
+    return trackCiphertext(context->EvalMult(a, b));
+}
+
+Ciphertext<DCRTPoly> evalMult(const CryptoContext<DCRTPoly> &context, const Ciphertext<DCRTPoly> &a, const Plaintext &b) {
+    countEvent(COUNT_EVAL_MULT);
+    return trackCiphertext(context->EvalMult(a, b));
+}
+
+Ciphertext<DCRTPoly> evalMultNoRelin(const CryptoContext<DCRTPoly> &context, const Ciphertext<DCRTPoly> &a, const Ciphertext<DCRTPoly> &b) {
+    countEvent(COUNT_EVAL_MULT);
+    return trackCiphertext(context->EvalMultNoRelin(a, b));
+}
+
+Ciphertext<DCRTPoly> relinearize(const CryptoContext<DCRTPoly> &context, const Ciphertext<DCRTPoly> &c) {
+    countEvent(COUNT_RELINEARIZATIONS);
+    return trackCiphertext(context->Relinearize(c));
+}
+
+Ciphertext<DCRTPoly> evalAdd(const CryptoContext<DCRTPoly> &context, const Ciphertext<DCRTPoly> &a, const Ciphertext<DCRTPoly> &b) {
+    countEvent(COUNT_EVAL_ADD);
+    return trackCiphertext(context->EvalAdd(a, b));
+}
+
+Ciphertext<DCRTPoly> evalAdd(const CryptoContext<DCRTPoly> &context, const Ciphertext<DCRTPoly> &a, const Plaintext &b) {
+    countEvent(COUNT_EVAL_ADD);
+    return trackCiphertext(context->EvalAdd(a, b));
+}
+
+Ciphertext<DCRTPoly> evalSub(const CryptoContext<DCRTPoly> &context, const Ciphertext<DCRTPoly> &a, const Ciphertext<DCRTPoly> &b) {
+    countEvent(COUNT_EVAL_ADD);
+    return trackCiphertext(context->EvalSub(a, b));
+}
+
+Ciphertext<DCRTPoly> evalSub(const CryptoContext<DCRTPoly> &context, const Ciphertext<DCRTPoly> &a, const Plaintext &b) {
+    countEvent(COUNT_EVAL_ADD);
+    return trackCiphertext(context->EvalSub(a, b));
+}
+
+Ciphertext<DCRTPoly> evalNegate(const CryptoContext<DCRTPoly> &context, const Ciphertext<DCRTPoly> &c) {
+    countEvent(COUNT_EVAL_ADD);
+    return trackCiphertext(context->EvalNegate(c));
+}
+
+Ciphertext<DCRTPoly> encryptPlaintext(const CryptoContext<DCRTPoly> &context, const PublicKey<DCRTPoly> &pk, const Plaintext &plaintext) {
+    countEvent(COUNT_ENCRYPTIONS);
+    return trackCiphertext(context->Encrypt(pk, plaintext));
+}
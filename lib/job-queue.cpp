@@ -0,0 +1,67 @@
+// Created on February 13 2023
+// By Julen Bernabe Rodriguez <julen.bernabe@tecnalia.com>
+// Copyright (c) 2023 Tecnalia Research & Innovation
+
+/*
+ * Bounded queue shared by producer and consumer threads
+ */
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+
+/*
+ * FIFO queue with a maximum size. Producers block while it is full, which propagates backpressure upstream
+ * (e.g. a connection stops reading its socket, and the client stops sending). After close(), push fails
+ * and pop drains the remaining items before failing.
+ */
+template <class T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : capacity(capacity < 1 ? 1 : capacity) {}
+
+    // Blocks while the queue is full; false if the queue was closed
+    bool push(T item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notFull.wait(lock, [this] { return closed || items.size() < capacity; });
+        if (closed) {
+            return false;
+        }
+        items.push_back(item);
+        notEmpty.notify_one();
+        return true;
+    }
+
+    // Blocks while the queue is empty; false if the queue was closed and is empty
+    bool pop(T &item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notEmpty.wait(lock, [this] { return closed || !items.empty(); });
+        if (items.empty()) {
+            return false;
+        }
+        item = items.front();
+        items.pop_front();
+        notFull.notify_one();
+        return true;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        notFull.notify_all();
+        notEmpty.notify_all();
+    }
+
+    size_t size() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return items.size();
+    }
+
+private:
+    size_t capacity;
+    bool closed = false;
+    std::deque<T> items;
+    std::mutex mutex;
+    std::condition_variable notFull;
+    std::condition_variable notEmpty;
+};
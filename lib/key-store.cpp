@@ -0,0 +1,266 @@
+// Created on February 13 2023
+// By Julen Bernabe Rodriguez <julen.bernabe@tecnalia.com>
+// Copyright (c) 2023 Tecnalia Research & Innovation
+
+/*
+ * Binary store of cryptographical contexts and key material
+ */
+
+#include "scheme/bgvrns/cryptocontext-bgvrns.h"
+#include "gen-cryptocontext.h"
+#include "cryptocontext-ser.h"
+#include "key/key-ser.h"
+#include "scheme/bgvrns/bgvrns-ser.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <streambuf>
+#include <functional>
+#include <map>
+#include <cstring>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace lbcrypto;
+
+/*
+ * Layout of a store (integers in native byte order):
+ *   magic "BGVKEYS\0", version (uint32), parameter plan (6 x uint32), number of sections (uint32),
+ *   for each section: name length (uint32), name, size (uint64),
+ *   then the data of every section, in the same order.
+ * Stores of another version are ignored, so the programs regenerate (and overwrite) them.
+ */
+const char keyStoreMagic[8] = {'B', 'G', 'V', 'K', 'E', 'Y', 'S', '\0'};
+const uint32_t keyStoreVersion = 1;
+
+/**
+ * @brief Section of a store: a named blob of serialized data
+ * 
+ * @param name name of the section (e.g. "context" or "secret-key")
+ * @param data serialized data
+ */
+struct KeyStoreSection {
+    std::string name;
+    std::string data;
+};
+
+typedef struct KeyStoreSection keyStoreSection;
+
+/**
+ * @brief Store mapped in memory (read only)
+ * 
+ * The sections are deserialized straight from the mapping, without copying the file.
+ * 
+ * @param data start of the mapped file
+ * @param size size of the file
+ * @param plan parameters the keys were generated for
+ * @param sections offset and size of each section
+ */
+struct KeyStore {
+    const char *data = nullptr;
+    size_t size = 0;
+    parameterPlan plan;
+    std::map<std::string, std::pair<uint64_t, uint64_t>> sections;
+
+    KeyStore() {}
+    KeyStore(const KeyStore &) = delete;
+    KeyStore &operator=(const KeyStore &) = delete;
+    ~KeyStore() {
+        if (data != nullptr) {
+            munmap((void *) data, size);
+        }
+    }
+};
+
+/*
+ * Read-only stream buffer over a memory region
+ */
+class MemoryStreamBuf : public std::streambuf {
+public:
+    MemoryStreamBuf(const char *data, size_t size) {
+        char *begin = const_cast<char *>(data);
+        setg(begin, begin, begin + size);
+    }
+};
+
+/*
+ * Whether two parameter plans are the same (keys of one plan are useless for another one).
+ */
+bool samePlan(const parameterPlan &a, const parameterPlan &b) {
+    return a.plaintextModulus == b.plaintextModulus && a.depth == b.depth && a.securityLevel == b.securityLevel &&
+           a.ringDimension == b.ringDimension && a.batchSize == b.batchSize && a.numLargeDigits == b.numLargeDigits;
+}
+
+/**
+ * @brief Serialize an OpenFHE object (context, key...) into a section
+ * 
+ * @param name name of the section
+ * @param object object to be serialized
+ * @return keyStoreSection containing the binary serialization of object
+ */
+template <class T>
+keyStoreSection serializedSection(std::string name, const T &object) {
+    std::ostringstream stream;
+    Serial::Serialize(object, stream, SerType::BINARY);
+    return {name, stream.str()};
+}
+
+/**
+ * @brief Write a store of sections
+ * 
+ * The store is written to a temporary file readable only by its owner (it may contain secret keys),
+ * which then replaces the previous store, so a concurrent reader never maps a partial store.
+ * 
+ * @param path file of the store
+ * @param plan parameters the keys were generated for
+ * @param sections sections of the store
+ * @return true if the store was written
+ */
+bool writeKeyStore(std::string path, const parameterPlan &plan, const std::vector<keyStoreSection> &sections) {
+    std::string tmpPath = path + ".tmp";
+    int fd = open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0 || fchmod(fd, 0600) != 0) {
+        if (fd >= 0) {
+            close(fd);
+        }
+        return false;
+    }
+    close(fd);
+    std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+
+    uint32_t header[8] = {keyStoreVersion, plan.plaintextModulus, plan.depth, (uint32_t) plan.securityLevel,
+                          plan.ringDimension, plan.batchSize, plan.numLargeDigits, (uint32_t) sections.size()};
+    file.write(keyStoreMagic, sizeof(keyStoreMagic));
+    file.write((const char *) header, sizeof(header));
+    for (uint i = 0; i < sections.size(); i++) {
+        uint32_t nameLength = sections[i].name.size();
+        uint64_t size = sections[i].data.size();
+        file.write((const char *) &nameLength, sizeof(nameLength));
+        file.write(sections[i].name.data(), nameLength);
+        file.write((const char *) &size, sizeof(size));
+    }
+    for (uint i = 0; i < sections.size(); i++) {
+        file.write(sections[i].data.data(), sections[i].data.size());
+    }
+    file.close();
+    if (!file || std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Map a store in memory and read its directory of sections
+ * 
+ * @param path file of the store
+ * @param store mapped store (only valid if true is returned)
+ * @return true if the file exists and is a store of the current version
+ */
+bool openKeyStore(std::string path, KeyStore &store) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        close(fd);
+        return false;
+    }
+    void *mapping = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+    store.data = (const char *) mapping;
+    store.size = info.st_size;
+
+    // Bounds-checked reader of the header
+    size_t position = 0;
+    auto readHeader = [&](void *out, size_t bytes) -> bool {
+        if (position + bytes > store.size) {
+            return false;
+        }
+        std::memcpy(out, store.data + position, bytes);
+        position += bytes;
+        return true;
+    };
+
+    char magic[8];
+    uint32_t header[8];
+    if (!readHeader(magic, sizeof(magic)) || std::memcmp(magic, keyStoreMagic, sizeof(magic)) != 0 ||
+        !readHeader(header, sizeof(header)) || header[0] != keyStoreVersion) {
+        return false;
+    }
+    store.plan.plaintextModulus = header[1];
+    store.plan.depth = header[2];
+    store.plan.securityLevel = (SecurityLevel) header[3];
+    store.plan.ringDimension = header[4];
+    store.plan.batchSize = header[5];
+    store.plan.numLargeDigits = header[6];
+
+    std::vector<std::pair<std::string, uint64_t>> directory;
+    for (uint32_t i = 0; i < header[7]; i++) {
+        uint32_t nameLength;
+        uint64_t size;
+        if (!readHeader(&nameLength, sizeof(nameLength)) || position + nameLength > store.size) {
+            return false;
+        }
+        std::string name(store.data + position, nameLength);
+        position += nameLength;
+        if (!readHeader(&size, sizeof(size))) {
+            return false;
+        }
+        directory.push_back({name, size});
+    }
+    for (uint i = 0; i < directory.size(); i++) {
+        if (directory[i].second > store.size - position) {
+            return false;
+        }
+        store.sections[directory[i].first] = {position, directory[i].second};
+        position += directory[i].second;
+    }
+    return true;
+}
+
+/**
+ * @brief Deserialize a section of a mapped store
+ * 
+ * @param store mapped store
+ * @param name name of the section
+ * @param read deserializes the section from a stream over the mapping
+ * @return true if the section exists and could be deserialized
+ */
+bool readSection(const KeyStore &store, std::string name, std::function<void(std::istream &)> read) {
+    auto section = store.sections.find(name);
+    if (section == store.sections.end()) {
+        return false;
+    }
+    MemoryStreamBuf buffer(store.data + section->second.first, section->second.second);
+    std::istream stream(&buffer);
+    try {
+        read(stream);
+    } catch (const std::exception &e) {
+        // A corrupt store is just regenerated
+        return false;
+    }
+    return !stream.fail();
+}
+
+/**
+ * @brief Deserialize an OpenFHE object (context, key...) from a section of a mapped store
+ * 
+ * @param store mapped store
+ * @param name name of the section
+ * @param object deserialized object
+ * @return true if the section exists and could be deserialized
+ */
+template <class T>
+bool readSerializedSection(const KeyStore &store, std::string name, T &object) {
+    return readSection(store, name, [&](std::istream &stream) {
+        Serial::Deserialize(object, stream, SerType::BINARY);
+    });
+}
@@ -11,6 +11,10 @@
 #include <limits>
 #include <iterator>
 #include <random>
+#include <cstdint>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 std::vector<uint> binaryRepresentationOfExp(uint n) {
     // Calculamos binary representation de n
@@ -26,45 +30,187 @@ std::vector<uint> binaryRepresentationOfExp(uint n) {
 }
 
 /*
- * Computes vector of uints containing: {c^{2⁰}, c^{2¹}, c^{2²}, ..., c^{2^{length(binaryRep}}}
+ * Computes a mod p in [0, p), also for negative a.
  * 
  */
-std::vector<int> clearPowersOfTwo(int n, int binaryRepresentationLength, int p) {
-    // Initialize vector of ciphertexts containing: {c^{2⁰}, c^{2¹}, c^{2²}, ..., c^{2^{length(binaryRep}}}
-    std::vector<int> preComputedValues;
+int64_t modP(int64_t a, int64_t p) {
+    int64_t result = a % p;
+    return result < 0 ? result + p : result;
+}
+
+/*
+ * Computes a * b mod p without overflow (the product is done with 128 bits), for a, b in [0, p).
+ * 
+ */
+int64_t mulMod(int64_t a, int64_t b, int64_t p) {
+    return (int64_t) ((unsigned __int128) a * (unsigned __int128) b % (unsigned __int128) p);
+}
+
+/*
+ * Computes vector containing: {n^{2⁰}, n^{2¹}, n^{2²}, ..., n^{2^{binaryRepresentationLength}}} mod p
+ * 
+ */
+std::vector<int64_t> clearPowersOfTwo(int64_t n, int binaryRepresentationLength, int64_t p) {
+    // Initialize vector containing: {n^{2⁰}, n^{2¹}, n^{2²}, ..., n^{2^{binaryRepresentationLength}}}
+    std::vector<int64_t> preComputedValues;
     
-    // Add c^{2⁰} = c to preComputedValues
-    preComputedValues.push_back(n);
+    // Add n^{2⁰} = n to preComputedValues
+    preComputedValues.push_back(modP(n, p));
 
     // Fill preComputedValues with remaining powers
     for (int i = 1; i <= binaryRepresentationLength; i++) {
-        preComputedValues.push_back((preComputedValues[i-1] * preComputedValues[i-1]) % p);
+        preComputedValues.push_back(mulMod(preComputedValues[i-1], preComputedValues[i-1], p));
     }
     return preComputedValues;
 }
 
 /*
  * Computes powers of integers mod p. Both the base and the exponent are public.
+ * The result is in [0, p) (negative bases are reduced first).
  * 
  */
-int clearPower(int n, int exp, int p) {
+int64_t clearPower(int64_t n, uint exp, int64_t p) {
     // Compute binary representation of exponent
     std::vector<uint> binaryRep = binaryRepresentationOfExp(exp);
 
-    // Compute vector {c^{2⁰}, c^{2¹}, c^{2²}, ..., c^{2^{length(binaryRep}}}
-    std::vector<int> preComputedValues = clearPowersOfTwo(n, binaryRep.size(), p);
+    // Compute vector {n^{2⁰}, n^{2¹}, n^{2²}, ..., n^{2^{length(binaryRep}}}
+    std::vector<int64_t> preComputedValues = clearPowersOfTwo(n, binaryRep.size(), p);
 
-    int result = 1;
-    // Compute encrypted result using preComputedValues
-    for (uint i = 0; i <= binaryRep.size(); i++) {
+    int64_t result = 1 % p;
+    // Compute result using preComputedValues
+    for (uint i = 0; i < binaryRep.size(); i++) {
         if (binaryRep[i] == 1) {
-            result = result * preComputedValues[i] % p;
+            result = mulMod(result, preComputedValues[i], p);
         }
     }
 
-    return result % p;   
+    return result;
 }
 
-int inverse(int n, int p) {
+/*
+ * Computes the inverse of n mod p (p prime, n not a multiple of p).
+ * 
+ */
+int64_t inverse(int64_t n, int64_t p) {
     return clearPower(n, p-2, p);
-}
\ No newline at end of file
+}
+
+/*
+ * Computes the distinct prime factors of n.
+ * 
+ */
+std::vector<int64_t> primeFactors(int64_t n) {
+    std::vector<int64_t> factors;
+    for (int64_t q = 2; q * q <= n; q++) {
+        if (n % q == 0) {
+            factors.push_back(q);
+            while (n % q == 0) {
+                n /= q;
+            }
+        }
+    }
+    if (n > 1) {
+        factors.push_back(n);
+    }
+    return factors;
+}
+
+/*
+ * Computes a generator of the multiplicative group Z_p^* (p prime).
+ * 
+ */
+int64_t multiplicativeGenerator(int64_t p) {
+    std::vector<int64_t> factors = primeFactors(p - 1);
+    for (int64_t g = 2; g < p; g++) {
+        bool isGenerator = true;
+        for (uint i = 0; i < factors.size() && isGenerator; i++) {
+            isGenerator = clearPower(g, (p - 1) / factors[i], p) != 1;
+        }
+        if (isGenerator) {
+            return g;
+        }
+    }
+    return 1;
+}
+
+/*
+ * Splits a non-negative integer into numLimbs digits in base `base` (least significant first).
+ * Digits above numLimbs are dropped, i.e. the value is taken modulo base^numLimbs.
+ * 
+ */
+std::vector<int64_t> toLimbs(uint64_t value, uint base, uint numLimbs) {
+    std::vector<int64_t> limbs;
+    for (uint i = 0; i < numLimbs; i++) {
+        limbs.push_back(value % base);
+        value /= base;
+    }
+    return limbs;
+}
+
+/*
+ * Recomposes an integer from its digits in base `base` (least significant first).
+ * Digits are reduced to [0, base) first, so decrypted limbs in (-p/2, p/2] can be passed directly.
+ * 
+ */
+uint64_t fromLimbs(std::vector<int64_t> limbs, uint base) {
+    uint64_t value = 0;
+    for (uint i = limbs.size(); i > 0; i--) {
+        value = value * base + modP(limbs[i-1], base);
+    }
+    return value;
+}
+
+/*
+ * Computes ceil(log2(n)) for n >= 1, i.e. the depth of c^n when computed with a balanced power ladder.
+ * 
+ */
+uint ceilLog2(uint n) {
+    uint result = 0;
+    while ((1u << result) < n) {
+        result++;
+    }
+    return result;
+}
+
+/*
+ * Number of threads used by the parallel evaluation kernels (powers, interpolation).
+ * With 1 thread the serial path is used and OpenFHE keeps parallelizing inside each operation;
+ * with more threads the kernels run independent operations concurrently and the nested OpenFHE
+ * loops run single-threaded (nested parallelism is disabled by default in OpenMP).
+ */
+int evalThreads = 1;
+
+void setEvalThreads(int threads) {
+    evalThreads = threads < 1 ? 1 : threads;
+}
+
+/*
+ * Maximum number of threads available to the parallel evaluation kernels.
+ * 
+ */
+int maxEvalThreads() {
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+/*
+ * Whether polynomials are evaluated by streaming the powers of their input (evalPolynomialsStreaming): O(log p)
+ * ciphertexts alive instead of O(sqrt(p)) for Paterson-Stockmeyer and O(p) for the task graphs of compareAll and
+ * intPrivDivision, for p-2 multiplications per input instead of O(sqrt(p)).
+ */
+bool streamingEvaluation = false;
+
+void setStreamingEvaluation(bool streaming) {
+    streamingEvaluation = streaming;
+}
+
+/*
+ * Key backend of some cryptoTools: how fresh ciphertexts are produced. The evaluation core (lib/core) is templated
+ * on the cryptoTools of the backend, and each backend specializes this policy in its basics, e.g.
+ *     static Ciphertext<DCRTPoly> encrypt(std::vector<int64_t> v, const cryptoTools &cc);
+ */
+template <class Tools>
+struct KeyBackend;
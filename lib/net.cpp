@@ -0,0 +1,227 @@
+// Created on February 13 2023
+// By Julen Bernabe Rodriguez <julen.bernabe@tecnalia.com>
+// Copyright (c) 2023 Tecnalia Research & Innovation
+
+/*
+ * Sockets and protocol between the evaluation clients and servers
+ */
+
+#include <iostream>
+#include <streambuf>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+/*
+ * Requests of the protocol. A session starts with REQUEST_SETUP (context, public key and evaluation keys of
+ * the client), then every request is its type followed by its inputs, and is answered with the number of
+ * result ciphertexts followed by the ciphertexts (0 results if the request failed).
+ *   REQUEST_SIGN:             c              -> sign(c)
+ *   REQUEST_COMPARE:          c1, c2         -> eq, gt, gteq, lt, lteq, max, min
+ *   REQUEST_PUBLIC_DIVISION:  divisor, c     -> c / divisor (divisor as int64)
+ *   REQUEST_PRIVATE_DIVISION: c1, c2         -> c1 / c2
+ */
+enum RequestType {
+    REQUEST_SETUP,
+    REQUEST_SIGN,
+    REQUEST_COMPARE,
+    REQUEST_PUBLIC_DIVISION,
+    REQUEST_PRIVATE_DIVISION,
+    REQUEST_CLOSE
+};
+
+// Default address of the evaluation server
+const std::string defaultServerAddress = "unix:bgv-server.sock";
+
+/*
+ * Buffered stream buffer over a socket. Ciphertexts are serialized into (and deserialized from) a fixed
+ * buffer that is exchanged with the socket as it fills up, so no message is ever copied whole in memory.
+ */
+class SocketStreamBuf : public std::streambuf {
+public:
+    explicit SocketStreamBuf(int fd, size_t bufferSize = 1 << 16) : fd(fd), input(bufferSize), output(bufferSize) {
+        setg(input.data(), input.data(), input.data());
+        setp(output.data(), output.data() + output.size());
+    }
+    ~SocketStreamBuf() {
+        sync();
+    }
+
+protected:
+    int underflow() override {
+        ssize_t received;
+        do {
+            received = recv(fd, input.data(), input.size(), 0);
+        } while (received < 0 && errno == EINTR);
+        if (received <= 0) {
+            return traits_type::eof();
+        }
+        setg(input.data(), input.data(), input.data() + received);
+        return traits_type::to_int_type(*gptr());
+    }
+    int overflow(int c) override {
+        if (flush() != 0) {
+            return traits_type::eof();
+        }
+        if (c != traits_type::eof()) {
+            *pptr() = traits_type::to_char_type(c);
+            pbump(1);
+        }
+        return traits_type::not_eof(c);
+    }
+    int sync() override {
+        return flush();
+    }
+
+private:
+    int flush() {
+        const char *data = pbase();
+        while (data < pptr()) {
+            ssize_t sent = send(fd, data, pptr() - data, MSG_NOSIGNAL);
+            if (sent < 0 && errno == EINTR) {
+                continue;
+            }
+            if (sent <= 0) {
+                return -1;
+            }
+            data += sent;
+        }
+        setp(output.data(), output.data() + output.size());
+        return 0;
+    }
+
+    int fd;
+    std::vector<char> input;
+    std::vector<char> output;
+};
+
+/*
+ * Writes (reads) a fixed-size value in native byte order.
+ */
+template <class T>
+void writeValue(std::ostream &stream, T value) {
+    stream.write((const char *) &value, sizeof(T));
+}
+
+template <class T>
+bool readValue(std::istream &stream, T &value) {
+    return (bool) stream.read((char *) &value, sizeof(T));
+}
+
+/*
+ * Splits an address "unix:<path>" or "<host>:<port>" and fills the Unix-domain socket address of the first form.
+ */
+bool unixAddress(std::string address, sockaddr_un &unixSocket) {
+    if (address.compare(0, 5, "unix:") != 0) {
+        return false;
+    }
+    std::memset(&unixSocket, 0, sizeof(unixSocket));
+    unixSocket.sun_family = AF_UNIX;
+    std::strncpy(unixSocket.sun_path, address.c_str() + 5, sizeof(unixSocket.sun_path) - 1);
+    return true;
+}
+
+/**
+ * @brief Resolve a TCP address "<host>:<port>" (host may be empty to listen on every interface)
+ * 
+ * @param address address to be resolved
+ * @param passive true to listen on the address
+ * @return addrinfo* list of candidate addresses (to be released with freeaddrinfo), nullptr on failure
+ */
+addrinfo *tcpAddress(std::string address, bool passive) {
+    size_t colon = address.rfind(':');
+    if (colon == std::string::npos) {
+        return nullptr;
+    }
+    std::string host = address.substr(0, colon);
+    std::string port = address.substr(colon + 1);
+    addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = passive ? AI_PASSIVE : 0;
+    addrinfo *result = nullptr;
+    if (getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(), &hints, &result) != 0) {
+        return nullptr;
+    }
+    return result;
+}
+
+/**
+ * @brief Listen on a Unix-domain ("unix:<path>") or TCP ("<host>:<port>") address
+ * 
+ * @param address address to listen on
+ * @return int listening socket, -1 on failure
+ */
+int listenSocket(std::string address) {
+    sockaddr_un unixSocket;
+    if (unixAddress(address, unixSocket)) {
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        unlink(unixSocket.sun_path);
+        if (fd < 0 || bind(fd, (sockaddr *) &unixSocket, sizeof(unixSocket)) != 0 || listen(fd, SOMAXCONN) != 0) {
+            if (fd >= 0) {
+                close(fd);
+            }
+            return -1;
+        }
+        return fd;
+    }
+    addrinfo *candidates = tcpAddress(address, true);
+    int fd = -1;
+    for (addrinfo *candidate = candidates; candidate != nullptr && fd < 0; candidate = candidate->ai_next) {
+        fd = socket(candidate->ai_family, candidate->ai_socktype, candidate->ai_protocol);
+        int reuse = 1;
+        if (fd >= 0 && (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) != 0 ||
+                        bind(fd, candidate->ai_addr, candidate->ai_addrlen) != 0 || listen(fd, SOMAXCONN) != 0)) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    if (candidates != nullptr) {
+        freeaddrinfo(candidates);
+    }
+    return fd;
+}
+
+/**
+ * @brief Connect to a Unix-domain ("unix:<path>") or TCP ("<host>:<port>") address
+ * 
+ * @param address address to connect to
+ * @return int connected socket, -1 on failure
+ */
+int connectSocket(std::string address) {
+    sockaddr_un unixSocket;
+    if (unixAddress(address, unixSocket)) {
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd >= 0 && connect(fd, (sockaddr *) &unixSocket, sizeof(unixSocket)) != 0) {
+            close(fd);
+            fd = -1;
+        }
+        return fd;
+    }
+    addrinfo *candidates = tcpAddress(address, false);
+    int fd = -1;
+    for (addrinfo *candidate = candidates; candidate != nullptr && fd < 0; candidate = candidate->ai_next) {
+        fd = socket(candidate->ai_family, candidate->ai_socktype, candidate->ai_protocol);
+        if (fd >= 0 && connect(fd, candidate->ai_addr, candidate->ai_addrlen) != 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    if (candidates != nullptr) {
+        freeaddrinfo(candidates);
+    }
+    if (fd >= 0) {
+        // Requests are small and latency bound: do not wait to coalesce them
+        int noDelay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    }
+    return fd;
+}
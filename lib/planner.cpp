@@ -0,0 +1,226 @@
+// Created on February 13 2023
+// By Julen Bernabe Rodriguez <julen.bernabe@tecnalia.com>
+// Copyright (c) 2023 Tecnalia Research & Innovation
+
+/*
+ * BGV parameter planner
+ */
+
+#include "scheme/bgvrns/cryptocontext-bgvrns.h"
+#include "gen-cryptocontext.h"
+
+#include <iostream>
+#include <functional>
+#include <stdexcept>
+#include <string>
+
+using namespace lbcrypto;
+
+/*
+ * Operations the parameters are planned for.
+ */
+enum PlannedOperation {
+    PLAN_SIGN,                  // sign
+    PLAN_COMPARE,               // a single predicate: equal, gt, gteq, lt, lteq
+    PLAN_COMPARE_ALL,           // compareAll (every predicate, max and min)
+    PLAN_MAX_MIN,               // max, min
+    PLAN_PUBLIC_DIVISION,       // intPubDivision
+    PLAN_PRIVATE_DIVISION,      // intPrivDivision
+    PLAN_MULTI_LIMB             // addIntegers, subIntegers, compareIntegers
+};
+
+/**
+ * @brief Parameters of a BGV cryptographical context
+ * 
+ * @param plaintextModulus plaintext modulus p
+ * @param depth multiplicative depth
+ * @param securityLevel security level (HEStd_NotSet for insecure test parameters)
+ * @param ringDimension ring dimension N (0 lets OpenFHE choose it for the security level)
+ * @param batchSize number of slots of the packed plaintexts
+ * @param numLargeDigits number of digits of the hybrid key switching
+ */
+struct ParameterPlan {
+    usint plaintextModulus;
+    usint depth;
+    SecurityLevel securityLevel;
+    usint ringDimension;
+    usint batchSize;
+    usint numLargeDigits;
+};
+
+typedef struct ParameterPlan parameterPlan;
+
+/*
+ * Multiplicative depth of an operation with the evaluation algorithms of the library. Under FIXEDAUTO a product
+ * by a plaintext raises the noise scale like a ciphertext product, so it spends a level too: an interpolation
+ * has depth ceil(log2(p-1)) for the powers plus one for the products by its coefficients.
+ */
+usint operationDepth(PlannedOperation operation, usint p, usint limbs) {
+    usint interpolation = ceilLog2(p - 1) + 1;
+    switch (operation) {
+        case PLAN_COMPARE_ALL:
+            // gt = (sign + 1 - eq) x 2^{-1}, then gt x (c1 - c2) for max and min
+            return interpolation + 2;
+        case PLAN_MAX_MIN:
+        case PLAN_PRIVATE_DIVISION:
+            // One product after the interpolation: g x c, and x^j R_j(d)
+            return interpolation + 1;
+        case PLAN_MULTI_LIMB:
+            // Limb-wise interpolations, the parallel prefix over the limbs, then the carries x base
+            return interpolation + ceilLog2(limbs) + 1;
+        default:
+            return interpolation;
+    }
+}
+
+/*
+ * Depth of every single-limb operation of the library (the depth of the contexts made without a plan).
+ */
+usint maxOperationDepth(usint p) {
+    usint depth = 1;
+    for (int operation = PLAN_SIGN; operation <= PLAN_PRIVATE_DIVISION; operation++) {
+        depth = std::max(depth, operationDepth((PlannedOperation) operation, p, 1));
+    }
+    return depth;
+}
+
+/*
+ * Largest power of two N such that 2N divides p-1, i.e. the largest ring with p-1 slots in
+ * which p supports packed encoding (OpenFHE needs a 2N-th root of unity mod p).
+ */
+usint maxPackingRingDimension(usint p) {
+    usint ring = 1;
+    while ((p - 1) % (4 * ring) == 0) {
+        ring *= 2;
+    }
+    return ring;
+}
+
+/*
+ * Smallest prime q >= p with q = 1 mod 2N, so that q supports packed encoding in a ring of dimension N.
+ */
+usint packingPlaintextModulus(usint p, usint ring) {
+    usint q = ((p - 1 + 2 * ring - 1) / (2 * ring)) * 2 * ring + 1;
+    while (true) {
+        bool isPrime = q > 2;
+        for (usint d = 2; d * d <= q && isPrime; d++) {
+            isPrime = q % d != 0;
+        }
+        if (isPrime) {
+            return q;
+        }
+        q += 2 * ring;
+    }
+}
+
+/*
+ * Estimated cost of a key switching (the bulk of every ciphertext product): the number of digits times
+ * the towers each digit is extended to, times the cost of an NTT.
+ */
+double keySwitchingCost(usint ring, usint towers, usint numLargeDigits) {
+    usint specialTowers = (towers + numLargeDigits - 1) / numLargeDigits;
+    return (double) numLargeDigits * (towers + specialTowers) * ring * ceilLog2(ring);
+}
+
+/**
+ * @brief Plan the parameters of a cryptographical context for a set of operations
+ * 
+ * The depth is the largest depth of the operations. With a security level, OpenFHE chooses the smallest
+ * secure ring for each number of key switching digits, and the combination with the lowest estimated
+ * key switching cost is kept. Packed encoding needs p = 1 mod 2N: if p does not allow it in the chosen
+ * ring, planning fails unless raiseModulus is set, in which case the plaintext modulus is raised to the
+ * smallest prime that does. That changes the range of the inputs and makes every interpolation far more
+ * expensive (e.g. 257 becomes 65537 for N = 16384), so callers opting in must read plan.plaintextModulus.
+ * Without a security level, the ring is the smallest one holding batchSize slots (or the largest one
+ * supported by p if batchSize is 0), with one digit.
+ * 
+ * @param p plaintext modulus
+ * @param operations operations to be run
+ * @param securityLevel security level
+ * @param batchSize number of slots needed (0 for as many as the ring offers)
+ * @param generate context generator of the backend (used to obtain the ring dimension and towers of each candidate)
+ * @param limbs number of limbs of the multi-limb integers (PLAN_MULTI_LIMB)
+ * @param raiseModulus whether p may be raised to a prime supporting packing in the secure ring
+ * @return parameterPlan ready to generate the cryptographical context
+ * @throws std::invalid_argument if p does not support packing in the secure ring and raiseModulus is not set
+ */
+parameterPlan planParameters(usint p, std::vector<PlannedOperation> operations, SecurityLevel securityLevel, usint batchSize,
+                             std::function<CryptoContext<DCRTPoly>(const parameterPlan &)> generate, usint limbs = 1,
+                             bool raiseModulus = false) {
+    parameterPlan plan;
+    plan.plaintextModulus = p;
+    plan.securityLevel = securityLevel;
+
+    while (true) {
+        plan.depth = 1;
+        for (uint i = 0; i < operations.size(); i++) {
+            plan.depth = std::max(plan.depth, operationDepth(operations[i], plan.plaintextModulus, limbs));
+        }
+
+        usint batchRing = 2;
+        while (batchRing < batchSize) {
+            batchRing *= 2;
+        }
+
+        if (securityLevel == HEStd_NotSet) {
+            plan.ringDimension = batchSize ? batchRing : std::max(batchRing, maxPackingRingDimension(plan.plaintextModulus));
+            plan.numLargeDigits = 1;
+        } else {
+            // Fewer digits are faster, but the larger special modulus may need a larger ring
+            double bestCost = 0;
+            usint bestRing = 0;
+            usint bestDigits = 1;
+            for (usint digits = 1; digits <= std::min(plan.depth + 1, 4u); digits++) {
+                plan.ringDimension = 0;
+                plan.numLargeDigits = digits;
+                plan.batchSize = 0;
+                CryptoContext<DCRTPoly> candidate = generate(plan);
+                usint ring = std::max(candidate->GetRingDimension(), batchRing);
+                double cost = keySwitchingCost(ring, candidate->GetElementParams()->GetParams().size(), digits);
+                if (bestRing == 0 || cost < bestCost) {
+                    bestCost = cost;
+                    bestRing = ring;
+                    bestDigits = digits;
+                }
+            }
+            plan.ringDimension = bestRing;
+            plan.numLargeDigits = bestDigits;
+        }
+
+        if ((plan.plaintextModulus - 1) % (2 * plan.ringDimension) == 0 || securityLevel == HEStd_NotSet) {
+            break;
+        }
+        if (!raiseModulus) {
+            throw std::invalid_argument("p = " + std::to_string(plan.plaintextModulus) + " does not support packing in the secure ring "
+                                        "of dimension " + std::to_string(plan.ringDimension) + " (p = 1 mod " +
+                                        std::to_string(2 * plan.ringDimension) + " is needed)");
+        }
+        // Raising p may raise the depth (and the ring), so plan again
+        plan.plaintextModulus = packingPlaintextModulus(plan.plaintextModulus, plan.ringDimension);
+    }
+
+    usint slots = std::min(plan.ringDimension, maxPackingRingDimension(plan.plaintextModulus));
+    plan.batchSize = batchSize ? std::min(batchSize, slots) : slots;
+    return plan;
+}
+
+/*
+ * Forces the ring dimension of a plan made without a security level (e.g. to sweep it in a benchmark), keeping as
+ * many slots of batchSize as the ring offers. False (and the plan unchanged) if p does not support packing in it.
+ */
+bool setPlanRingDimension(parameterPlan &plan, usint ring, usint batchSize) {
+    if (ring == 0 || (plan.plaintextModulus - 1) % (2 * ring) != 0) {
+        return false;
+    }
+    plan.ringDimension = ring;
+    plan.batchSize = batchSize ? std::min(batchSize, ring) : ring;
+    return true;
+}
+
+/*
+ * Prints a parameter plan.
+ */
+void printParameterPlan(const parameterPlan &plan) {
+    std::cout << "p = " << plan.plaintextModulus << ", depth = " << plan.depth << ", ring dimension = " << plan.ringDimension
+              << ", slots = " << plan.batchSize << ", key switching digits = " << plan.numLargeDigits << std::endl;
+}
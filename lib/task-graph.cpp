@@ -0,0 +1,159 @@
+// Created on February 13 2023
+// By Julen Bernabe Rodriguez <julen.bernabe@tecnalia.com>
+// Copyright (c) 2023 Tecnalia Research & Innovation
+
+/*
+ * Task graph of homomorphic operations
+ */
+
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <functional>
+#include <exception>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/*
+ * Graph of operations with dependencies between them. Each node computes a value from the values of its
+ * inputs, and runs as soon as all its inputs are ready, concurrently with the other ready nodes (as OpenMP
+ * tasks: idle threads take the tasks spawned by busy ones). The value of a node is freed once its last
+ * consumer has finished, unless it is kept as a result.
+ */
+template <class T>
+class TaskGraph {
+public:
+    typedef std::function<T(const std::vector<T>&)> Operation;
+
+    // Node holding a value that is already known
+    size_t input(T value) {
+        return addNode(nullptr, {}, value);
+    }
+
+    // Node computing operation(values of the inputs) once every input is ready
+    size_t add(Operation operation, std::vector<size_t> inputs) {
+        return addNode(operation, inputs, T());
+    }
+
+    // Keep the value of a node after run() (the values of the other nodes are freed when no longer needed)
+    void keep(size_t node) {
+        nodes[node].kept = true;
+    }
+
+    // Runs every node with up to threads threads; rethrows the first exception thrown by a node
+    void run(int threads) {
+        waiting.reset(new std::atomic<size_t>[nodes.size()]);
+        pendingConsumers.reset(new std::atomic<size_t>[nodes.size()]);
+        failed = false;
+        error = nullptr;
+        std::vector<size_t> ready;
+        for (size_t i = 0; i < nodes.size(); i++) {
+            waiting[i] = nodes[i].done ? 0 : nodes[i].inputs.size();
+            pendingConsumers[i] = nodes[i].consumers.size();
+            if (!nodes[i].done && nodes[i].inputs.empty()) {
+                ready.push_back(i);
+            }
+        }
+        for (size_t i = 0; i < nodes.size(); i++) {
+            if (nodes[i].done) {
+                release(i);
+                for (size_t j = 0; j < nodes[i].consumers.size(); j++) {
+                    if (--waiting[nodes[i].consumers[j]] == 0) {
+                        ready.push_back(nodes[i].consumers[j]);
+                    }
+                }
+            }
+        }
+
+        #pragma omp parallel num_threads(threads) copyin(activeFrame) if(threads > 1)
+        #pragma omp single
+        for (size_t i = 0; i < ready.size(); i++) {
+            size_t node = ready[i];
+            #pragma omp task firstprivate(node)
+            runNode(node);
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    T value(size_t node) const {
+        return values[node];
+    }
+
+    size_t size() const {
+        return nodes.size();
+    }
+
+private:
+    struct Node {
+        Operation operation;
+        std::vector<size_t> inputs;
+        std::vector<size_t> consumers;
+        bool kept = false;
+        bool done = false;
+    };
+
+    size_t addNode(Operation operation, std::vector<size_t> inputs, T value) {
+        size_t id = nodes.size();
+        Node node;
+        node.operation = operation;
+        node.inputs = inputs;
+        node.done = !operation;
+        nodes.push_back(node);
+        values.push_back(value);
+        for (size_t i = 0; i < inputs.size(); i++) {
+            nodes[inputs[i]].consumers.push_back(id);
+        }
+        return id;
+    }
+
+    // Frees the value of a node that is not a result once no consumer is left
+    void release(size_t node) {
+        if (pendingConsumers[node] == 0 && !nodes[node].kept) {
+            values[node] = T();
+        }
+    }
+
+    void runNode(size_t node) {
+        if (!failed) {
+            try {
+                std::vector<T> arguments(nodes[node].inputs.size());
+                for (size_t i = 0; i < arguments.size(); i++) {
+                    arguments[i] = values[nodes[node].inputs[i]];
+                }
+                values[node] = nodes[node].operation(arguments);
+            } catch (...) {
+                #pragma omp critical(taskGraphError)
+                if (!failed) {
+                    error = std::current_exception();
+                    failed = true;
+                }
+            }
+        }
+        nodes[node].done = true;
+        for (size_t i = 0; i < nodes[node].inputs.size(); i++) {
+            size_t input = nodes[node].inputs[i];
+            if (--pendingConsumers[input] == 0) {
+                release(input);
+            }
+        }
+        release(node);
+        // The consumers that were only waiting for this node become ready
+        for (size_t i = 0; i < nodes[node].consumers.size(); i++) {
+            size_t consumer = nodes[node].consumers[i];
+            if (--waiting[consumer] == 0) {
+                #pragma omp task firstprivate(consumer)
+                runNode(consumer);
+            }
+        }
+    }
+
+    std::vector<Node> nodes;
+    std::vector<T> values;
+    std::unique_ptr<std::atomic<size_t>[]> waiting;
+    std::unique_ptr<std::atomic<size_t>[]> pendingConsumers;
+    std::atomic<bool> failed;
+    std::exception_ptr error;
+};
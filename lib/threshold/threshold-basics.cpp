@@ -76,22 +76,87 @@ CryptoContext<DCRTPoly> GenerateThresholdBGVrnsContext(usint ptm, usint multDept
     return cc;
 }
 
+/**
+ * @brief generate the cryptographical context for threshold BGV of a parameter plan (see planParameters)
+ * 
+ * The noise flooding of the multiparty decryption enlarges the modulus, so plans for threshold BGV must be
+ * made with this generator.
+ * 
+ * @param plan planned parameters
+ * @return CryptoContext<DCRTPoly> cryptographical context
+ */
+CryptoContext<DCRTPoly> GeneratePlannedThresholdBGVrnsContext(const parameterPlan &plan) {
+    CCParams<CryptoContextBGVRNS> parameters;
+    parameters.SetPlaintextModulus(plan.plaintextModulus);
+    parameters.SetMultiplicativeDepth(plan.depth);
+    parameters.SetSecurityLevel(plan.securityLevel);
+    parameters.SetMultipartyMode(NOISE_FLOODING_MULTIPARTY);
+    parameters.SetRingDim(plan.ringDimension);
+    parameters.SetBatchSize(plan.batchSize);
+    parameters.SetNumLargeDigits(plan.numLargeDigits);
+    parameters.SetKeySwitchTechnique(HYBRID);
+    parameters.SetScalingTechnique(FIXEDAUTO);
+
+    CryptoContext<DCRTPoly> cc = GenCryptoContext(parameters);
+    cc->Enable(PKE);
+    cc->Enable(KEYSWITCH);
+    cc->Enable(LEVELEDSHE);
+    cc->Enable(ADVANCEDSHE);
+    cc->Enable(MULTIPARTY);
+
+    return cc;
+}
+
+/**
+ * @brief generate cryptoTools (cryptographical context + public keys + secret keys) of a parameter plan
+ * 
+ * @param plan planned parameters
+ * @return cryptoTools (cryptographical context + public keys + secret keys)
+ */
+cryptoTools genThresholdBGVCryptoTools(const parameterPlan &plan) {
+    cryptoTools cc;
+
+    // Generate context with the planned parameters
+    cc.cryptoContext = GeneratePlannedThresholdBGVrnsContext(plan);
+
+    // Key generation
+    KeyPair<DCRTPoly> keys = cc.cryptoContext->KeyGen();
+    cc.pks.push_back(keys.publicKey);
+    cc.sks.push_back(keys.secretKey);
+    cc.lastKey = 0;
+    return cc;
+}
+
+/**
+ * @brief plan the parameters for some operations on values mod p and generate cryptoTools
+ * 
+ * @param p plaintext modulus (see planParameters)
+ * @param operations operations to be run
+ * @param securityLevel security level
+ * @param batchSize number of slots needed (0 for as many as the ring offers)
+ * @param raiseModulus whether p may be raised to support packing in the secure ring (see planParameters)
+ * @return cryptoTools (cryptographical context + public keys + secret keys)
+ */
+cryptoTools genThresholdBGVCryptoTools(usint p, std::vector<PlannedOperation> operations, SecurityLevel securityLevel, usint batchSize,
+                                       bool raiseModulus = false) {
+    parameterPlan plan = planParameters(p, operations, securityLevel, batchSize, GeneratePlannedThresholdBGVrnsContext, 1, raiseModulus);
+    printParameterPlan(plan);
+    return genThresholdBGVCryptoTools(plan);
+}
+
 /**
  * @brief generate cryptoTools (cryptographical context + public keys + secret keys)
  * 
  * @param p plaintext modulus
  * @param level ring dimension
+ * @param depth multiplicative depth
  * @return cryptoTools (cryptographical context + public keys + secret keys)
  */
-cryptoTools genThresholdBGVCryptoTools(usint p, usint level) {
+cryptoTools genThresholdBGVCryptoTools(usint p, usint level, usint depth) {
     cryptoTools cc;
 
-    // compute binary representation of p-1
-    std::vector<uint> binaryRep = binaryRepresentationOfExp(p-1);
-    
     // Define parameters of BGV cryptographic context
     usint ptm                  = p;
-    usint depth                = binaryRep.size() + 1;      // Maximum depth needed is the binary representation of p-1
 
     // Generate context with above parameters
     cc.cryptoContext = GenerateThresholdBGVrnsContext(ptm, depth, level);
@@ -104,6 +169,11 @@ cryptoTools genThresholdBGVCryptoTools(usint p, usint level) {
     return cc;
 }
 
+cryptoTools genThresholdBGVCryptoTools(usint p, usint level) {
+    // Deep enough for every operation, including the plaintext products (see operationDepth)
+    return genThresholdBGVCryptoTools(p, level, maxOperationDepth(p));
+}
+
 /**
  * @brief generate ck encapsulating sk_k for Pk
  * 
@@ -199,6 +269,72 @@ CryptoContext<DCRTPoly> setFinalMultKey(EvalKey<DCRTPoly> finalMultKey, CryptoCo
     return cc;
 }
 
+/**
+ * @brief run the key ceremony of two players A and B: keys, joint public key pk* and evaluation key
+ * 
+ * In a deployment each step runs at its player, and thresholdTools travels between them as commented below.
+ * 
+ * @param plan planned parameters
+ * @param tt thresholdTools containing the added and final evaluation keys (output)
+ * @return cryptoTools with the keys of both players and the final evaluation key set in the context
+ */
+cryptoTools twoPartyKeyCeremony(const parameterPlan &plan, thresholdTools &tt) {
+    cryptoTools cc = genThresholdBGVCryptoTools(plan);
+
+    tt = init(cc.sks[0], cc.cryptoContext);
+
+    // Now thresholdTools is sent to party B
+
+    // party B generates her multi-party key (appended at the end of keys in cryptoTools)
+    cc = newMultiPartyKey(cc);
+
+    // then uses this multi-party key to update threshold keys
+    tt.AddedKey = updateAddedMultKey(tt.AddedKey, cc.sks[1], cc.pks[1], cc.cryptoContext);
+
+    // Now thresholdTools is sent again to party A to update MultKey
+
+    // party A initializes the final mult key version (using added mult key)
+    tt.MultKey = initFinalMultKey(tt.AddedKey, cc.sks[0], cc.pks[0], cc.cryptoContext);
+
+    // Now thresholdTools is sent back to party B to update MultKey
+    tt.MultKey = updateFinalMultKey(tt.AddedKey, tt.MultKey, cc.sks[1], cc.pks[1], cc.cryptoContext);
+
+    // Now set final MultKey
+    cc.cryptoContext = setFinalMultKey(tt.MultKey, cc.cryptoContext);
+
+    return cc;
+}
+
+/**
+ * @brief encrypt a vector of integers (one per slot) using threshold cryptographical context
+ * 
+ * Every operation of the library works slot-wise, so a vector of up to batch-size integers is processed
+ * at the cost of a single integer.
+ * 
+ * @param v integers to be encrypted
+ * @param pk threshold public key
+ * @param cc cryptographical context
+ * @return Ciphertext<DCRTPoly> ciphertext encrypting v
+ */
+Ciphertext<DCRTPoly> encryptVThresholdBGV(std::vector<int64_t> v, PublicKey<DCRTPoly> pk, CryptoContext<DCRTPoly> cc) {
+    // Encode vector as plaintext
+    Plaintext plaintext               = cc->MakePackedPlaintext(v);
+
+    // Encrypt plaintext
+    Ciphertext<DCRTPoly> ciphertext   = encryptPlaintext(cc, pk, plaintext);
+    return ciphertext;
+}
+
+/*
+ * Threshold backend of the evaluation core: fresh ciphertexts are encrypted under the joint public key pk*.
+ */
+template <>
+struct KeyBackend<cryptoTools> {
+    static Ciphertext<DCRTPoly> encrypt(std::vector<int64_t> v, const cryptoTools &cc) {
+        return encryptVThresholdBGV(v, cc.pks[cc.lastKey], cc.cryptoContext);
+    }
+};
+
 /**
  * @brief encrypt integer using threshold cryptographical context
  * 
@@ -215,7 +351,7 @@ Ciphertext<DCRTPoly> encryptThresholdBGV(int n, PublicKey<DCRTPoly> pk, CryptoCo
     Plaintext plaintext               = cc->MakePackedPlaintext(vectorOfInts);
 
     // Encrypt plaintext
-    Ciphertext<DCRTPoly> ciphertext   = cc->Encrypt(pk, plaintext);
+    Ciphertext<DCRTPoly> ciphertext   = encryptPlaintext(cc, pk, plaintext);
     return ciphertext;
 }
 
@@ -0,0 +1,127 @@
+/**
+ * @ Author: Julen Bernabe Rodriguez <julen.bernabe@tecnalia.com>
+ * @ Create Time: 2023-06-14 11:50:19
+ * @ Description: Copyright (c) 2023 Tecnalia Research & Innovation
+ */
+
+/*
+ * Threshold key store
+ */
+
+#include "scheme/bgvrns/cryptocontext-bgvrns.h"
+#include "gen-cryptocontext.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+
+using namespace lbcrypto;
+
+/**
+ * @brief Store the public part of the threshold setup: context, public keys and evaluation keys
+ * 
+ * The secret key shares are stored apart, one store per party (see saveThresholdShare).
+ * 
+ * @param cc cryptoTools containing the context and the public keys {pk_1, ..., pk*}
+ * @param tt thresholdTools containing the added and final evaluation keys
+ * @param plan parameters cc was generated for
+ * @param path file of the store
+ * @return true if the store was written
+ */
+bool saveThresholdTools(const cryptoTools &cc, const thresholdTools &tt, const parameterPlan &plan, std::string path) {
+    std::vector<keyStoreSection> sections;
+    sections.push_back(serializedSection("context", cc.cryptoContext));
+    for (uint k = 0; k < cc.pks.size(); k++) {
+        sections.push_back(serializedSection("public-key/" + std::to_string(k), cc.pks[k]));
+    }
+    sections.push_back(serializedSection("added-key", tt.AddedKey));
+    sections.push_back(serializedSection("mult-key", tt.MultKey));
+    return writeKeyStore(path, plan, sections);
+}
+
+/**
+ * @brief Store the secret key share sk_k of player Pk
+ * 
+ * @param cc cryptoTools containing the secret key shares
+ * @param party index k of the player
+ * @param plan parameters cc was generated for
+ * @param path file of the store of Pk
+ * @return true if the store was written
+ */
+bool saveThresholdShare(const cryptoTools &cc, uint party, const parameterPlan &plan, std::string path) {
+    std::vector<keyStoreSection> sections;
+    sections.push_back(serializedSection("secret-key", cc.sks[party]));
+    return writeKeyStore(path, plan, sections);
+}
+
+/**
+ * @brief Store the whole threshold setup: the share of every player, then the public store
+ * 
+ * The public store is written last and removed if any store could not be written, so a failed save never
+ * leaves a public store next to the shares of an older ceremony.
+ * 
+ * @param cc cryptoTools containing the context and the keys
+ * @param tt thresholdTools containing the added and final evaluation keys
+ * @param plan parameters cc was generated for
+ * @param path file of the public store
+ * @param sharePaths files of the stores of the players, in the order of the players
+ * @return true if every store was written
+ */
+bool saveThresholdSetup(const cryptoTools &cc, const thresholdTools &tt, const parameterPlan &plan, std::string path, std::vector<std::string> sharePaths) {
+    bool saved = true;
+    for (uint k = 0; k < sharePaths.size(); k++) {
+        saved = saveThresholdShare(cc, k, plan, sharePaths[k]) && saved;
+    }
+    saved = saved && saveThresholdTools(cc, tt, plan, path);
+    if (!saved) {
+        std::remove(path.c_str());
+    }
+    return saved;
+}
+
+/**
+ * @brief Load the threshold setup and the secret key shares of the players, and set the final evaluation key
+ * 
+ * @param cc loaded cryptoTools (unchanged if false is returned)
+ * @param tt loaded thresholdTools (unchanged if false is returned)
+ * @param plan parameters the keys must have been generated for
+ * @param path file of the public store
+ * @param sharePaths files of the stores of the players, in the order of the players
+ * @return true if every store exists, is complete and was generated for plan by the same key ceremony
+ */
+bool loadThresholdTools(cryptoTools &cc, thresholdTools &tt, const parameterPlan &plan, std::string path, std::vector<std::string> sharePaths) {
+    KeyStore store;
+    if (!openKeyStore(path, store) || !samePlan(store.plan, plan)) {
+        return false;
+    }
+    cryptoTools loaded;
+    thresholdTools loadedKeys;
+    // The keys refer to the context, so they are loaded after it
+    if (!readSerializedSection(store, "context", loaded.cryptoContext)) {
+        return false;
+    }
+    loaded.pks.resize(sharePaths.size());
+    loaded.sks.resize(sharePaths.size());
+    for (uint k = 0; k < sharePaths.size(); k++) {
+        KeyStore share;
+        if (!readSerializedSection(store, "public-key/" + std::to_string(k), loaded.pks[k]) ||
+            !openKeyStore(sharePaths[k], share) || !samePlan(share.plan, plan) ||
+            !readSerializedSection(share, "secret-key", loaded.sks[k])) {
+            return false;
+        }
+        // A share of another ceremony (e.g. a store left over by a failed save) would decrypt garbage
+        if (loaded.sks[k]->GetKeyTag() != loaded.pks[k]->GetKeyTag()) {
+            return false;
+        }
+    }
+    if (!readSerializedSection(store, "added-key", loadedKeys.AddedKey) ||
+        !readSerializedSection(store, "mult-key", loadedKeys.MultKey)) {
+        return false;
+    }
+    loaded.lastKey = sharePaths.size() - 1;
+    loaded.cryptoContext = setFinalMultKey(loadedKeys.MultKey, loaded.cryptoContext);
+    cc = loaded;
+    tt = loadedKeys;
+    return true;
+}
@@ -0,0 +1,99 @@
+// Created on February 13 2023
+// By Julen Bernabe Rodriguez <julen.bernabe@tecnalia.com>
+// Copyright (c) 2023 Tecnalia Research & Innovation
+
+/*
+ * Ciphertext wire format
+ */
+
+#include "scheme/bgvrns/cryptocontext-bgvrns.h"
+#include "gen-cryptocontext.h"
+#include "cryptocontext-ser.h"
+#include "ciphertext-ser.h"
+#include "scheme/bgvrns/bgvrns-ser.h"
+
+#include <iostream>
+#include <streambuf>
+
+using namespace lbcrypto;
+
+// Towers left by compactCiphertext: the noise of BGV after modulus switching does not depend on the
+// modulus, so the first tower alone still decrypts
+const usint wireTowers = 1;
+
+/*
+ * Stream buffer that only counts the bytes written to it
+ */
+class CountingStreamBuf : public std::streambuf {
+public:
+    size_t count = 0;
+
+protected:
+    int overflow(int c) override {
+        if (c != traits_type::eof()) {
+            count++;
+        }
+        return traits_type::not_eof(c);
+    }
+    std::streamsize xsputn(const char *, std::streamsize n) override {
+        count += n;
+        return n;
+    }
+};
+
+/**
+ * @brief Switch a ciphertext down to the lowest level that still decrypts
+ * 
+ * The results of the evaluation are left at whatever level the evaluation reached, and every remaining
+ * tower is sent (and processed by the decryption) for nothing. Only results can be compacted: a ciphertext
+ * at the lowest level admits no more products.
+ * 
+ * @param c ciphertext to be sent for decryption
+ * @param cc cryptographical context
+ * @return Ciphertext<DCRTPoly> c with wireTowers towers
+ */
+Ciphertext<DCRTPoly> compactCiphertext(Ciphertext<DCRTPoly> c, CryptoContext<DCRTPoly> cc) {
+    if (c->GetElements()[0].GetNumOfElements() <= wireTowers) {
+        return c;
+    }
+    return cc->Compress(c, wireTowers);
+}
+
+/**
+ * @brief Write a ciphertext in the binary wire format (straight to the stream, without intermediate copies)
+ * 
+ * @param stream stream the ciphertext is written to
+ * @param c ciphertext (use compactCiphertext first for results)
+ */
+void writeCiphertext(std::ostream &stream, Ciphertext<DCRTPoly> c) {
+    Serial::Serialize(c, stream, SerType::BINARY);
+}
+
+/**
+ * @brief Read a ciphertext in the binary wire format (its context must be loaded in this process)
+ * 
+ * @param stream stream the ciphertext is read from
+ * @param c read ciphertext
+ * @return true if a ciphertext could be read
+ */
+bool readCiphertext(std::istream &stream, Ciphertext<DCRTPoly> &c) {
+    try {
+        Serial::Deserialize(c, stream, SerType::BINARY);
+    } catch (const std::exception &e) {
+        return false;
+    }
+    return !stream.fail();
+}
+
+/**
+ * @brief Number of bytes of a ciphertext in the binary wire format
+ * 
+ * @param c ciphertext
+ * @return size_t size of the serialization of c
+ */
+size_t wireSize(Ciphertext<DCRTPoly> c) {
+    CountingStreamBuf counter;
+    std::ostream stream(&counter);
+    writeCiphertext(stream, c);
+    return counter.count;
+}
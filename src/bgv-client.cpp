@@ -0,0 +1,154 @@
+// Created on February 13 2023
+// By Julen Bernabe Rodriguez <julen.bernabe@tecnalia.com>
+// Copyright (c) 2023 Tecnalia Research & Innovation
+
+/*
+ * BGV evaluation client program
+ */
+
+#include "scheme/bgvrns/cryptocontext-bgvrns.h"
+#include "gen-cryptocontext.h"
+
+#include <iostream>
+#include <fstream>
+#include <limits>
+#include <iterator>
+#include <random>
+#include <chrono>
+#include "../lib/lib.cpp"
+#include "../lib/counters.cpp"
+#include "../lib/task-graph.cpp"
+#include "../lib/planner.cpp"
+#include "../lib/key-store.cpp"
+#include "../lib/wire.cpp"
+#include "../lib/net.cpp"
+#include "../lib/bgv/bgv-basics.cpp"
+#include "../lib/bgv/bgv-key-store.cpp"
+#include "../lib/core/core-power.cpp"
+#include "../lib/core/core-interpolation.cpp"
+#include "../lib/core/core-plan-cache.cpp"
+#include "../lib/core/core-compare.cpp"
+#include "../lib/bgv/bgv-client.cpp"
+
+using namespace lbcrypto;
+
+/*
+ * Reads an integer of the signed range of the plaintext modulus.
+ */
+int readInteger(std::string prompt, int p) {
+    int n;
+    std::cout << prompt;
+    std::cin >> n;
+    while (n > (p-1)/2 || n < -(p-1)/2) {
+        std::cout << "\nInteger must be between " << -(p - 1) / 2 << " and " << (p - 1) / 2 << std::endl;
+        std::cout << prompt;
+        std::cin >> n;
+    }
+    return n;
+}
+
+/*
+ * Prints the end-to-end time of a request (encryption excluded, transfer and evaluation included).
+ */
+void printLatency(std::chrono::steady_clock::time_point start) {
+    double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "\nEnd-to-end time: " << milliseconds << " ms" << std::endl;
+}
+
+void remoteGetSign(evaluationClient &client, cryptoTools cc, int p) {
+    int first = readInteger("Enter integer to obtain sign: ", p);
+    Ciphertext<DCRTPoly> c1 = encrypt(first, cc);
+
+    auto start = std::chrono::steady_clock::now();
+    Ciphertext<DCRTPoly> cSign = remoteSign(client, c1);
+    printLatency(start);
+    if (cSign == nullptr) {
+        std::cout << "The server could not evaluate the request" << std::endl;
+        return;
+    }
+    std::cout << "Result: " << decrypt(cSign, cc)[0] << std::endl;
+}
+
+void remoteIntComparator(evaluationClient &client, cryptoTools cc, int p) {
+    int first = readInteger("\t - First integer: ", p);
+    int second = readInteger("\t - Second integer: ", p);
+    Ciphertext<DCRTPoly> c1 = encrypt(first, cc);
+    Ciphertext<DCRTPoly> c2 = encrypt(second, cc);
+
+    auto start = std::chrono::steady_clock::now();
+    comparisonResults results = remoteCompareAll(client, c1, c2);
+    printLatency(start);
+    if (results.eq == nullptr) {
+        std::cout << "The server could not evaluate the request" << std::endl;
+        return;
+    }
+    std::cout << first << " == " << second << ": " << decrypt(results.eq, cc)[0] << std::endl;
+    std::cout << first << " > " << second << ": " << decrypt(results.gt, cc)[0] << std::endl;
+    std::cout << first << " >= " << second << ": " << decrypt(results.gteq, cc)[0] << std::endl;
+    std::cout << first << " < " << second << ": " << decrypt(results.lt, cc)[0] << std::endl;
+    std::cout << first << " <= " << second << ": " << decrypt(results.lteq, cc)[0] << std::endl;
+    std::cout << "max(" << first << ", " <<  second << ") = " << decrypt(results.max, cc)[0] << std::endl;
+    std::cout << "min(" << first << ", " <<  second << ") = " << decrypt(results.min, cc)[0] << std::endl;
+}
+
+void remoteIntDivision(evaluationClient &client, cryptoTools cc, int p) {
+    int dividend = readInteger("Enter dividend: ", p);
+    int divisor = readInteger("Enter divisor: ", p);
+    Ciphertext<DCRTPoly> cDividend = encrypt(dividend, cc);
+    Ciphertext<DCRTPoly> cDivisor = encrypt(divisor, cc);
+
+    auto start = std::chrono::steady_clock::now();
+    Ciphertext<DCRTPoly> cPubQuotient = remotePublicDivision(client, cDividend, divisor);
+    printLatency(start);
+    if (cPubQuotient != nullptr) {
+        std::cout << "Public division result: " << decrypt(cPubQuotient, cc)[0] << std::endl;
+    }
+
+    start = std::chrono::steady_clock::now();
+    Ciphertext<DCRTPoly> cPrivQuotient = remotePrivateDivision(client, cDividend, cDivisor);
+    printLatency(start);
+    if (cPrivQuotient != nullptr) {
+        std::cout << "Private division result: " << decrypt(cPrivQuotient, cc)[0] << std::endl;
+    }
+}
+
+std::string intro() {
+
+    std::cout << "\n\n############# BGV EVALUATION CLIENT #############\n\n"<< std::endl;
+    std::cout << "Choose between:"<< std::endl;
+    std::cout << "\t - Sign of number (S)"<< std::endl;
+    std::cout << "\t - Integer comparator (IC)"<< std::endl;
+    std::cout << "\t - Integer division (ID)"<< std::endl;
+    std::cout << "\t - Quit (Q)"<< std::endl;
+    std::string operation;
+    std::cin >> operation;
+    return operation;
+}
+
+int main(int argc, char **argv) {
+    std::string address = argc > 1 ? argv[1] : defaultServerAddress;
+
+    cryptoTools cc = loadOrGenCryptoTools("bgv-client.keys", 257, {PLAN_SIGN, PLAN_COMPARE_ALL, PLAN_PUBLIC_DIVISION, PLAN_PRIVATE_DIVISION}, HEStd_NotSet, 0);
+    int p = cc.cryptoContext->GetCryptoParameters()->GetPlaintextModulus();
+
+    evaluationClient client;
+    if (!connectEvaluationServer(client, address, cc)) {
+        std::cout << "Cannot connect to the evaluation server at " << address << std::endl;
+        return 1;
+    }
+
+    std::string operation = intro();
+    while (operation != "Q") {
+        if (operation == "S") {
+            remoteGetSign(client, cc, p);
+        } else if (operation == "IC") {
+            remoteIntComparator(client, cc, p);
+        } else if (operation == "ID") {
+            remoteIntDivision(client, cc, p);
+        } else {
+            std::cout << "Please, introduce a valid value."<< std::endl;
+        }
+        operation = intro();
+    }
+    closeEvaluationClient(client);
+}
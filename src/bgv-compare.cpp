@@ -15,11 +15,23 @@
 #include <iterator>
 #include <random>
 #include <time.h>
+#include <chrono>
 #include "../lib/lib.cpp"
+#include "../lib/counters.cpp"
+#include "../lib/task-graph.cpp"
+#include "../lib/planner.cpp"
+#include "../lib/key-store.cpp"
+#include "../lib/wire.cpp"
 #include "../lib/bgv/bgv-basics.cpp"
-#include "../lib/bgv/bgv-power.cpp"
-#include "../lib/bgv/bgv-interpolation.cpp"
-#include "../lib/bgv/bgv-compare.cpp"
+#include "../lib/bgv/bgv-key-store.cpp"
+#include "../lib/core/core-power.cpp"
+#include "../lib/core/core-interpolation.cpp"
+#include "../lib/core/core-plan-cache.cpp"
+#include "../lib/core/core-compare.cpp"
+#include "../lib/core/core-int-division.cpp"
+#include "../lib/core/core-multi-limb.cpp"
+#include "../lib/bgv/bgv-multi-limb.cpp"
+#include "../lib/core/core-expression.cpp"
 
 using namespace lbcrypto;
 
@@ -29,7 +41,7 @@ void getSign() {
     std::cout << "\nBGV GET SIGN\n "<< std::endl;
 
     // -------------------- CLIENT SIDE --------------------
-    cryptoTools cc = genCryptoTools(257, 2);
+    cryptoTools cc = loadOrGenCryptoTools("bgv-sign.keys", 257, {PLAN_SIGN}, HEStd_NotSet, 0);
     int first;
     std::cout << "Enter integer to obtain sign: "<< std::endl;
     std::cin >> first;
@@ -51,7 +63,10 @@ void getSign() {
 
     // -----------------------------------------------------
 
-    // Here the result is sent to the client
+    // Here the result is sent to the client, switched down to the smallest modulus that decrypts
+    std::cout << "\nResult size: " << wireSize(cSign) << " bytes";
+    cSign = compactCiphertext(cSign, cc.cryptoContext);
+    std::cout << ", " << wireSize(cSign) << " bytes on the wire" << std::endl;
 
     // -------------------- CLIENT SIDE --------------------
 
@@ -66,7 +81,7 @@ void intComparator() {
     std::cout << "\nBGV INTEGER COMPARATOR\n "<< std::endl;
 
     // -------------------- CLIENT SIDE --------------------
-    cryptoTools cc = genCryptoTools(257, 2);
+    cryptoTools cc = loadOrGenCryptoTools("bgv-compare.keys", 257, {PLAN_COMPARE_ALL}, HEStd_NotSet, 0);
     int p = cc.cryptoContext->GetCryptoParameters()->GetPlaintextModulus();
     int first, second;
     std::cout << "Enter two integers: "<< std::endl;
@@ -107,19 +122,30 @@ void intComparator() {
     time_t timer2;
     double seconds;
     time(&timer1);
-    Ciphertext<DCRTPoly> cEq = equal(c1, c2, cc);
-    Ciphertext<DCRTPoly> cGreater = gt(c1, c2, cc);
-    Ciphertext<DCRTPoly> cGreaterEq = gteq(c1, c2, cc);
-    Ciphertext<DCRTPoly> cLower = lt(c1, c2, cc);
-    Ciphertext<DCRTPoly> cLowerEq = lteq(c1, c2, cc);
-    Ciphertext<DCRTPoly> cMax = max(c1, c2, cc);
-    Ciphertext<DCRTPoly> cMin = min(c1, c2, cc);
+    // The independent operations of the task graph run concurrently on every core
+    setEvalThreads(maxEvalThreads());
+    comparisonResults results = compareAll(c1, c2, cc);
+    setEvalThreads(1);
+    Ciphertext<DCRTPoly> cEq = results.eq;
+    Ciphertext<DCRTPoly> cGreater = results.gt;
+    Ciphertext<DCRTPoly> cGreaterEq = results.gteq;
+    Ciphertext<DCRTPoly> cLower = results.lt;
+    Ciphertext<DCRTPoly> cLowerEq = results.lteq;
+    Ciphertext<DCRTPoly> cMax = results.max;
+    Ciphertext<DCRTPoly> cMin = results.min;
     time(&timer2);
     seconds = difftime(timer2,timer1);
 
     // -----------------------------------------------------
 
-    // Here the result is sent to the client
+    // Here the result is sent to the client, switched down to the smallest modulus that decrypts
+    cEq = compactCiphertext(cEq, cc.cryptoContext);
+    cGreater = compactCiphertext(cGreater, cc.cryptoContext);
+    cGreaterEq = compactCiphertext(cGreaterEq, cc.cryptoContext);
+    cLower = compactCiphertext(cLower, cc.cryptoContext);
+    cLowerEq = compactCiphertext(cLowerEq, cc.cryptoContext);
+    cMax = compactCiphertext(cMax, cc.cryptoContext);
+    cMin = compactCiphertext(cMin, cc.cryptoContext);
 
     // -------------------- CLIENT SIDE --------------------
 
@@ -140,12 +166,204 @@ void intComparator() {
     std::cout << "\nTime used to compute: " << seconds << " seconds "<< std::endl;
 }
 
+void largeIntComparator() {
+
+    std::cout << "\nBGV LARGE INTEGER COMPARATOR\n "<< std::endl;
+
+    // -------------------- CLIENT SIDE --------------------
+    // 32-bit integers as 8 limbs in base 16
+    uint base = 16;
+    uint numLimbs = 8;
+    cryptoTools cc = loadOrGenCryptoTools("bgv-multi-limb.keys", 257, {PLAN_MULTI_LIMB}, HEStd_NotSet, 0, numLimbs);
+    uint32_t first, second;
+    std::cout << "Enter two non-negative 32-bit integers: "<< std::endl;
+    std::cout << "\t - First integer: ";
+    std::cin >> first;
+    std::cout << "\t - Second integer: ";
+    std::cin >> second;
+
+    encryptedInteger c1 = encryptInteger(first, base, numLimbs, cc);
+    encryptedInteger c2 = encryptInteger(second, base, numLimbs, cc);
+
+    // -----------------------------------------------------
+
+    // Here the ciphertexts are sent to the server
+
+    // -------------------- SERVER SIDE --------------------
+    time_t timer1;
+    time_t timer2;
+    double seconds;
+    time(&timer1);
+    integerComparisons results = compareIntegers(c1, c2, cc);
+    encryptedInteger cSum = addIntegers(c1, c2, cc);
+    encryptedInteger cDifference = subIntegers(c1, c2, cc);
+    time(&timer2);
+    seconds = difftime(timer2,timer1);
+
+    // -----------------------------------------------------
+
+    // Here the result is sent to the client
+
+    // -------------------- CLIENT SIDE --------------------
+
+    std::vector<int64_t> rEq = decrypt(results.eq, cc);
+    std::vector<int64_t> rGreater = decrypt(results.gt, cc);
+    std::vector<int64_t> rLower = decrypt(results.lt, cc);
+    std::cout << first << " == " << second << ": " << rEq[0] << std::endl;
+    std::cout << first << " > " << second << ": " << rGreater[0] << std::endl;
+    std::cout << first << " < " << second << ": " << rLower[0] << std::endl;
+    std::cout << first << " + " << second << " (mod 2^32) = " << decryptInteger(cSum, cc) << std::endl;
+    std::cout << first << " - " << second << " (mod 2^32) = " << decryptInteger(cDifference, cc) << std::endl;
+    std::cout << "\nTime used to compute: " << seconds << " seconds "<< std::endl;
+}
+
+void batchedComparator() {
+
+    std::cout << "\nBGV BATCHED INTEGER COMPARATOR\n "<< std::endl;
+
+    // -------------------- CLIENT SIDE --------------------
+    cryptoTools cc = loadOrGenCryptoTools("bgv-compare.keys", 257, {PLAN_COMPARE_ALL}, HEStd_NotSet, 0);
+    int p = cc.cryptoContext->GetCryptoParameters()->GetPlaintextModulus();
+    usint slots = slotCount(cc);
+
+    // One random pair per slot
+    std::mt19937 generator(time(nullptr));
+    std::uniform_int_distribution<int64_t> distribution(-(p - 1) / 4, (p - 1) / 4);
+    std::vector<int64_t> first(slots), second(slots);
+    for (usint i = 0; i < slots; i++) {
+        first[i] = distribution(generator);
+        second[i] = distribution(generator);
+    }
+
+    Ciphertext<DCRTPoly> c1 = encryptV(first, cc);
+    Ciphertext<DCRTPoly> c2 = encryptV(second, cc);
+
+    // -----------------------------------------------------
+
+    // Here the ciphertexts are sent to the server
+
+    // -------------------- SERVER SIDE --------------------
+    auto start = std::chrono::steady_clock::now();
+    comparisonResults results = compareAll(c1, c2, cc);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // -----------------------------------------------------
+
+    // Here the result is sent to the client, switched down to the smallest modulus that decrypts
+    results.gt = compactCiphertext(results.gt, cc.cryptoContext);
+    results.max = compactCiphertext(results.max, cc.cryptoContext);
+
+    // -------------------- CLIENT SIDE --------------------
+
+    std::vector<int64_t> rGreater = decrypt(results.gt, cc);
+    std::vector<int64_t> rMax = decrypt(results.max, cc);
+    usint errors = 0;
+    for (usint i = 0; i < slots; i++) {
+        if (rGreater[i] != (first[i] > second[i]) || rMax[i] != std::max(first[i], second[i])) {
+            errors++;
+        }
+    }
+    for (usint i = 0; i < std::min(slots, 4u); i++) {
+        std::cout << first[i] << " > " << second[i] << ": " << rGreater[i] << ", max = " << rMax[i] << std::endl;
+    }
+    std::cout << "\nCompared " << slots << " pairs (" << errors << " errors)" << std::endl;
+    std::cout << "Time used to compute: " << seconds << " seconds (" << seconds / slots << " seconds per pair)" << std::endl;
+}
+
+void parallelSpeedup() {
+
+    std::cout << "\nBGV PARALLEL SPEEDUP\n "<< std::endl;
+
+    cryptoTools cc = loadOrGenCryptoTools("bgv-sign.keys", 257, {PLAN_SIGN}, HEStd_NotSet, 0);
+    int first;
+    std::cout << "Enter integer to obtain sign: "<< std::endl;
+    std::cin >> first;
+
+    Ciphertext<DCRTPoly> c1 = encrypt(first, cc);
+
+    // Untimed run, so neither timing pays for interpolating and encoding the plan (see getInterpolationPlan)
+    setEvalThreads(1);
+    sign(c1, cc);
+
+    // Serial path
+    auto start = std::chrono::steady_clock::now();
+    Ciphertext<DCRTPoly> cSerial = sign(c1, cc);
+    double serialSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Parallel path using every available core
+    setEvalThreads(maxEvalThreads());
+    start = std::chrono::steady_clock::now();
+    Ciphertext<DCRTPoly> cParallel = sign(c1, cc);
+    double parallelSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    setEvalThreads(1);
+
+    std::vector<int64_t> rSerial = decrypt(cSerial, cc);
+    std::vector<int64_t> rParallel = decrypt(cParallel, cc);
+    std::cout << "\nResult (serial / parallel): " << rSerial[0] << " / " << rParallel[0] << std::endl;
+    std::cout << "Serial time: " << serialSeconds << " seconds" << std::endl;
+    std::cout << "Parallel time (" << maxEvalThreads() << " threads): " << parallelSeconds << " seconds" << std::endl;
+    std::cout << "Speedup: " << serialSeconds / parallelSeconds << "x" << std::endl;
+}
+
+void sharedQuery() {
+
+    std::cout << "\nBGV QUERY WITH SHARED WORK\n "<< std::endl;
+
+    // -------------------- CLIENT SIDE --------------------
+    cryptoTools cc = loadOrGenCryptoTools("bgv-compare.keys", 257, {PLAN_COMPARE_ALL}, HEStd_NotSet, 0);
+    int first, second;
+    std::cout << "Enter two integers: "<< std::endl;
+    std::cout << "\t - First integer: ";
+    std::cin >> first;
+    std::cout << "\t - Second integer: ";
+    std::cin >> second;
+
+    Ciphertext<DCRTPoly> c1 = encrypt(first, cc);
+    Ciphertext<DCRTPoly> c2 = encrypt(second, cc);
+
+    // -----------------------------------------------------
+
+    // Here the ciphertexts are sent to the server
+
+    // -------------------- SERVER SIDE --------------------
+    // gt, lt, max and min of the same pair, written as independent predicates: they share one difference
+    // (c2 - c1 is rewritten as -(c1 - c2)), one set of its powers, and the product of max and min
+    auto start = std::chrono::steady_clock::now();
+    ExpressionBuilder<cryptoTools> query(cc);
+    size_t a = query.input(c1);
+    size_t b = query.input(c2);
+    std::vector<size_t> outputs = {query.gt(a, b), query.lt(b, a), query.max(a, b), query.min(b, a)};
+    std::vector<Ciphertext<DCRTPoly>> results = query.evaluate(outputs);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // -----------------------------------------------------
+
+    // Here the result is sent to the client, switched down to the smallest modulus that decrypts
+    for (uint i = 0; i < results.size(); i++) {
+        results[i] = compactCiphertext(results[i], cc.cryptoContext);
+    }
+
+    // -------------------- CLIENT SIDE --------------------
+
+    std::cout << first << " > " << second << ": " << decrypt(results[0], cc)[0] << std::endl;
+    std::cout << second << " < " << first << ": " << decrypt(results[1], cc)[0] << std::endl;
+    std::cout << "max(" << first << ", " <<  second << ") = " << decrypt(results[2], cc)[0] << std::endl;
+    std::cout << "min(" << second << ", " <<  first << ") = " << decrypt(results[3], cc)[0] << std::endl;
+    std::cout << "\nExpression nodes: " << query.size() << std::endl;
+    std::cout << "Time used to compute: " << seconds << " seconds "<< std::endl;
+}
+
 std::string intro() {
 
     std::cout << "\n\n############# BGV COMPARATOR #############\n\n"<< std::endl;
     std::cout << "Choose between:"<< std::endl;
     std::cout << "\t - Integer comparison (IC)"<< std::endl;
+    std::cout << "\t - Batched integer comparison, one pair per slot (BC)"<< std::endl;
     std::cout << "\t - Sign of number (S)"<< std::endl;
+    std::cout << "\t - Large integer comparison and arithmetic (LIC)"<< std::endl;
+    std::cout << "\t - Parallel speedup of sign (PS)"<< std::endl;
+    std::cout << "\t - Several predicates of a pair, with shared work (SQ)"<< std::endl;
+    std::cout << "\t - Operation counters so far (OC)"<< std::endl;
     std::cout << "\t - Quit (Q)"<< std::endl;
     std::string operation;
     std::cin >> operation;
@@ -154,15 +372,27 @@ std::string intro() {
 
 int main() {
 
+    loadPlanCache(planCachePath);
     std::string operation = intro();
     while (operation != "Q") {
         if (operation == "IC") {
             intComparator();
+        } else if (operation == "BC") {
+            batchedComparator();
         } else if (operation == "S") {
             getSign();
+        } else if (operation == "LIC") {
+            largeIntComparator();
+        } else if (operation == "PS") {
+            parallelSpeedup();
+        } else if (operation == "SQ") {
+            sharedQuery();
+        } else if (operation == "OC") {
+            dumpOperationCounts(std::cout);
         } else {
             std::cout << "Please, introduce a valid value."<< std::endl;
         }
+        savePlanCache(planCachePath);
         operation = intro();
     }
 }
\ No newline at end of file
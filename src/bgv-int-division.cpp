@@ -16,11 +16,18 @@
 #include <random>
 #include <time.h>
 #include "../lib/lib.cpp"
+#include "../lib/counters.cpp"
+#include "../lib/task-graph.cpp"
+#include "../lib/planner.cpp"
+#include "../lib/key-store.cpp"
+#include "../lib/wire.cpp"
 #include "../lib/bgv/bgv-basics.cpp"
-#include "../lib/bgv/bgv-power.cpp"
-#include "../lib/bgv/bgv-interpolation.cpp"
-#include "../lib/bgv/bgv-compare.cpp"
-#include "../lib/bgv/bgv-int-division.cpp"
+#include "../lib/bgv/bgv-key-store.cpp"
+#include "../lib/core/core-power.cpp"
+#include "../lib/core/core-interpolation.cpp"
+#include "../lib/core/core-plan-cache.cpp"
+#include "../lib/core/core-compare.cpp"
+#include "../lib/core/core-int-division.cpp"
 
 
 std::string intro() {
@@ -28,6 +35,8 @@ std::string intro() {
     std::cout << "\n\n############# BGV INTEGER DIVISION #############\n\n"<< std::endl;
     std::cout << "Choose between:"<< std::endl;
     std::cout << "\t - Integer division (ID)"<< std::endl;
+    std::cout << "\t - Batched public division, one dividend per slot (BD)"<< std::endl;
+    std::cout << "\t - Operation counters so far (OC)"<< std::endl;
     std::cout << "\t - Quit (Q)"<< std::endl;
     std::string operation;
     std::cin >> operation;
@@ -39,7 +48,7 @@ void intDivision() {
     std::cout << "\nBGV INTEGER DIVISION\n "<< std::endl;
 
     // -------------------- CLIENT SIDE --------------------
-    cryptoTools cc = genCryptoTools(257, 2);
+    cryptoTools cc = loadOrGenCryptoTools("bgv-division.keys", 257, {PLAN_PUBLIC_DIVISION, PLAN_PRIVATE_DIVISION}, HEStd_NotSet, 0);
     int p = cc.cryptoContext->GetCryptoParameters()->GetPlaintextModulus();
     int dividend, divisor;
     std::cout << "(Client) Enter dividend: ";
@@ -83,16 +92,20 @@ void intDivision() {
     Ciphertext<DCRTPoly> cPubQuotient = intPubDivision(cDividend, divisor, cc);
     time(&timer2);
     seconds1 = difftime(timer2,timer1);
-    std::vector<int64_t> result1 = decrypt(cPubQuotient, cc);
+    std::vector<int64_t> result1 = decrypt(compactCiphertext(cPubQuotient, cc.cryptoContext), cc);
     std::cout << "\nPublic division result: " << result1[0] << std::endl;
     std::cout << "\nTime used to divide: " << seconds1 << " seconds "<< std::endl;
+    // The independent operations of the task graph run concurrently on every core
+    setEvalThreads(maxEvalThreads());
     Ciphertext<DCRTPoly> cPrivQuotient = intPrivDivision(cDividend, cDivisor, cc);
+    setEvalThreads(1);
     time(&timer3);
     seconds2 = difftime(timer3,timer2);
 
     // -----------------------------------------------------
 
-    // Here the result is sent to the client
+    // Here the result is sent to the client, switched down to the smallest modulus that decrypts
+    cPrivQuotient = compactCiphertext(cPrivQuotient, cc.cryptoContext);
 
     // -------------------- CLIENT SIDE --------------------
 
@@ -101,15 +114,82 @@ void intDivision() {
     std::cout << "\nTime used to divide: " << seconds2 << " seconds "<< std::endl;
 }
 
+void batchedDivision() {
+
+    std::cout << "\nBGV BATCHED INTEGER DIVISION\n "<< std::endl;
+
+    // -------------------- CLIENT SIDE --------------------
+    cryptoTools cc = loadOrGenCryptoTools("bgv-division.keys", 257, {PLAN_PUBLIC_DIVISION, PLAN_PRIVATE_DIVISION}, HEStd_NotSet, 0);
+    int p = cc.cryptoContext->GetCryptoParameters()->GetPlaintextModulus();
+    usint slots = slotCount(cc);
+
+    // One random dividend per slot
+    std::mt19937 generator(time(nullptr));
+    std::uniform_int_distribution<int64_t> distribution(-(p - 1) / 2, (p - 1) / 2);
+    std::vector<int64_t> dividends(slots);
+    for (usint i = 0; i < slots; i++) {
+        dividends[i] = distribution(generator);
+    }
+
+    Ciphertext<DCRTPoly> cDividends = encryptV(dividends, cc);
+
+    // -----------------------------------------------------
+
+    // Here the ciphertexts are sent to the server
+
+    // -------------------- SERVER SIDE --------------------
+    int divisor;
+    std::cout << "(Server) Enter divisor:  ";
+    std::cin >> divisor;
+    while (divisor > (p-1)/2 || divisor < -(p-1)/2) {
+        std::cout << "\nDivisor must be between " << -(p - 1) / 2 << " and " << (p - 1) / 2 << std::endl;
+        std::cout << "(Server) Enter divisor: ";
+        std::cin >> divisor;
+    }
+    time_t timer1;
+    time_t timer2;
+    double seconds;
+    time(&timer1);
+    Ciphertext<DCRTPoly> cQuotients = intPubDivision(cDividends, divisor, cc);
+    time(&timer2);
+    seconds = difftime(timer2,timer1);
+
+    // -----------------------------------------------------
+
+    // Here the result is sent to the client, switched down to the smallest modulus that decrypts
+    cQuotients = compactCiphertext(cQuotients, cc.cryptoContext);
+
+    // -------------------- CLIENT SIDE --------------------
+
+    std::vector<int64_t> quotients = decrypt(cQuotients, cc);
+    usint errors = 0;
+    for (usint i = 0; i < slots; i++) {
+        if (quotients[i] != (divisor != 0 ? dividends[i] / divisor : 0)) {
+            errors++;
+        }
+    }
+    for (usint i = 0; i < std::min(slots, 4u); i++) {
+        std::cout << dividends[i] << " / " << divisor << " = " << quotients[i] << std::endl;
+    }
+    std::cout << "\nDivided " << slots << " dividends (" << errors << " errors)" << std::endl;
+    std::cout << "Time used to divide: " << seconds << " seconds "<< std::endl;
+}
+
 int main() {
 
+    loadPlanCache(planCachePath);
     std::string operation = intro();
     while (operation != "Q") {
         if (operation == "ID") {
             intDivision();
+        } else if (operation == "BD") {
+            batchedDivision();
+        } else if (operation == "OC") {
+            dumpOperationCounts(std::cout);
         } else {
             std::cout << "Please, introduce a valid value."<< std::endl;
         }
+        savePlanCache(planCachePath);
         operation = intro();
     }
 }
\ No newline at end of file
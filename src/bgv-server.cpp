@@ -0,0 +1,71 @@
+// Created on February 13 2023
+// By Julen Bernabe Rodriguez <julen.bernabe@tecnalia.com>
+// Copyright (c) 2023 Tecnalia Research & Innovation
+
+/*
+ * BGV evaluation server program
+ */
+
+#include "scheme/bgvrns/cryptocontext-bgvrns.h"
+#include "gen-cryptocontext.h"
+
+#include <iostream>
+#include <fstream>
+#include <limits>
+#include <iterator>
+#include <random>
+#include <thread>
+#include "../lib/lib.cpp"
+#include "../lib/counters.cpp"
+#include "../lib/task-graph.cpp"
+#include "../lib/planner.cpp"
+#include "../lib/key-store.cpp"
+#include "../lib/wire.cpp"
+#include "../lib/net.cpp"
+#include "../lib/job-queue.cpp"
+#include "../lib/bgv/bgv-basics.cpp"
+#include "../lib/core/core-power.cpp"
+#include "../lib/core/core-interpolation.cpp"
+#include "../lib/core/core-plan-cache.cpp"
+#include "../lib/core/core-compare.cpp"
+#include "../lib/core/core-int-division.cpp"
+#include "../lib/bgv/bgv-server.cpp"
+
+using namespace lbcrypto;
+
+int main(int argc, char **argv) {
+    std::string address = argc > 1 ? argv[1] : defaultServerAddress;
+    uint workers = argc > 2 ? std::stoul(argv[2]) : std::max(1u, std::thread::hardware_concurrency());
+    uint queueSize = argc > 3 ? std::stoul(argv[3]) : 2 * workers;
+    uint64_t memoryBudgetMiB = argc > 4 ? std::stoull(argv[4]) : 0;
+    setMemoryBudget(memoryBudgetMiB * 1048576);
+
+    loadPlanCache(planCachePath);
+    int listener = listenSocket(address);
+    if (listener < 0) {
+        std::cout << "Cannot listen on " << address << std::endl;
+        return 1;
+    }
+    std::cout << "BGV evaluation server listening on " << address << " (" << workers << " workers, " << queueSize << " queued jobs";
+    if (memoryBudgetMiB) {
+        std::cout << ", " << memoryBudgetMiB << " MiB of ciphertexts";
+    }
+    std::cout << ")" << std::endl;
+
+    EvaluationDaemon daemon(queueSize, 4);
+    startWorkers(daemon, workers);
+
+    while (true) {
+        int fd = accept(listener, nullptr, nullptr);
+        if (fd < 0) {
+            continue;
+        }
+        int noDelay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        std::thread([&daemon, fd] {
+            serveClient(daemon, fd);
+            close(fd);
+            savePlanCache(planCachePath);
+        }).detach();
+    }
+}
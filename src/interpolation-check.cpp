@@ -0,0 +1,222 @@
+// Created on February 13 2023
+// By Julen Bernabe Rodriguez <julen.bernabe@tecnalia.com>
+// Copyright (c) 2023 Tecnalia Research & Innovation
+
+/*
+ * Clear-side check of the interpolation: the full-domain transform and the 128-bit modular arithmetic
+ * against the O(p^2) genericInterpolation and the textbook Lagrange formula (no encryption involved)
+ */
+
+#include "scheme/bgvrns/cryptocontext-bgvrns.h"
+#include "gen-cryptocontext.h"
+
+#include <iostream>
+#include <iterator>
+#include <random>
+#include "../lib/lib.cpp"
+#include "../lib/counters.cpp"
+#include "../lib/task-graph.cpp"
+#include "../lib/core/core-power.cpp"
+#include "../lib/core/core-interpolation.cpp"
+#include "../lib/core/core-plan-cache.cpp"
+#include "../lib/core/core-compare.cpp"
+#include "../lib/core/core-int-division.cpp"
+
+using namespace lbcrypto;
+
+/*
+ * Computes a * b mod p by doubling and adding (no 128-bit product), for a, b in [0, p) and p < 2^62.
+ *
+ */
+int64_t referenceMulMod(int64_t a, int64_t b, int64_t p) {
+    int64_t result = 0;
+    while (b > 0) {
+        if (b & 1) {
+            result = (result + a) % p;
+        }
+        a = (a + a) % p;
+        b >>= 1;
+    }
+    return result;
+}
+
+/*
+ * Textbook Lagrange formula: sum_i fx_i prod_{j != i} (x - x_j) / (x_i - x_j), each product expanded
+ * from scratch in O(n^2), so O(n^3) overall. Only used for small p.
+ *
+ */
+std::vector<int64_t> textbookLagrange(const std::vector<int64_t> &x, const std::vector<int64_t> &fx, int p) {
+    uint n = x.size();
+    std::vector<int64_t> result(n, 0);
+    for (uint i = 0; i < n; i++) {
+        std::vector<int64_t> basis(1, 1);
+        int64_t denominator = 1;
+        for (uint j = 0; j < n; j++) {
+            if (j == i) {
+                continue;
+            }
+            // basis = basis * (x - x_j)
+            std::vector<int64_t> product(basis.size() + 1, 0);
+            for (uint k = 0; k < basis.size(); k++) {
+                product[k + 1] = (product[k + 1] + basis[k]) % p;
+                product[k] = modP(product[k] - mulMod(basis[k], x[j], p), p);
+            }
+            basis = product;
+            denominator = mulMod(denominator, modP(x[i] - x[j], p), p);
+        }
+        int64_t scalar = mulMod(fx[i], inverse(denominator, p), p);
+        for (uint k = 0; k < n; k++) {
+            result[k] = (result[k] + mulMod(scalar, basis[k], p)) % p;
+        }
+    }
+    return result;
+}
+
+/*
+ * Horner evaluation of px at a, in [0, p).
+ *
+ */
+int64_t evalClearPoly(const std::vector<int64_t> &px, int64_t a, int64_t p) {
+    int64_t result = 0;
+    for (uint k = px.size(); k > 0; k--) {
+        result = (mulMod(result, a, p) + px[k-1]) % p;
+    }
+    return result;
+}
+
+/*
+ * Compares two coefficient vectors and prints the first mismatch. Returns the number of mismatches.
+ *
+ */
+uint compareCoefficients(std::string name, std::string reference, const std::vector<int64_t> &got, const std::vector<int64_t> &expected) {
+    if (got.size() != expected.size()) {
+        std::cout << name << ": " << got.size() << " coefficients, " << reference << " has " << expected.size() << std::endl;
+        return 1;
+    }
+    uint mismatches = 0;
+    for (uint k = 0; k < got.size(); k++) {
+        if (got[k] != expected[k]) {
+            if (mismatches == 0) {
+                std::cout << name << ": coefficient " << k << " is " << got[k] << ", " << reference << " gives " << expected[k] << std::endl;
+            }
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+/*
+ * Checks the polynomial of one table. For small p, every coefficient is compared with genericInterpolation
+ * and the textbook Lagrange formula. For large p (where those are too slow), a sample of coefficients is
+ * compared with the closed form c_k = -sum_{a != 0} f(a) a^{p-1-k} summed directly, and the polynomial is
+ * evaluated at a sample of points. Returns the number of mismatches.
+ *
+ */
+uint checkTable(std::string name, interpolationPoints ip, int p, std::mt19937 &rng) {
+    std::vector<int64_t> x = normalizePoly(ip.x, p);
+    std::vector<int64_t> fx = normalizePoly(ip.fx, p);
+    std::vector<int64_t> poly = getLagrangePoly(ip, p);
+    name += " (p = " + std::to_string(p) + ")";
+    uint mismatches = 0;
+
+    if (p <= 257) {
+        mismatches += compareCoefficients(name, "genericInterpolation", poly, genericInterpolation(x, fx, p));
+        mismatches += compareCoefficients(name, "the Lagrange formula", poly, textbookLagrange(x, fx, p));
+        for (int i = 0; i < p; i++) {
+            if (evalClearPoly(poly, x[i], p) != fx[i]) {
+                mismatches++;
+            }
+        }
+    } else {
+        std::vector<int64_t> values(p);
+        for (int i = 0; i < p; i++) {
+            values[x[i]] = fx[i];
+        }
+        std::uniform_int_distribution<int> uniform(0, p - 1);
+        std::vector<int> ks = {0, 1, 2, p - 2, p - 1};
+        for (int s = 0; s < 32; s++) {
+            ks.push_back(uniform(rng));
+        }
+        std::vector<int64_t> got, expected;
+        for (int k : ks) {
+            int64_t sum = 0;
+            if (k == 0) {
+                sum = values[0];
+            } else {
+                int exp = (k == p - 1) ? 0 : p - 1 - k;
+                for (int a = 1; a < p; a++) {
+                    sum = (sum + mulMod(values[a], clearPower(a, exp, p), p)) % p;
+                }
+                // The sum for k = p-1 runs over every a, 0 included
+                sum = modP(-(sum + (k == p - 1 ? values[0] : 0)), p);
+            }
+            got.push_back(poly[k]);
+            expected.push_back(sum);
+        }
+        mismatches += compareCoefficients(name, "the direct sum", got, expected);
+
+        std::vector<int> samples = {0, 1, (p - 1) / 2, (p + 1) / 2, p - 1};
+        for (int s = 0; s < 64; s++) {
+            samples.push_back(uniform(rng));
+        }
+        for (int i : samples) {
+            if (evalClearPoly(poly, x[i], p) != fx[i]) {
+                if (mismatches == 0) {
+                    std::cout << name << ": wrong value at " << ip.x[i] << std::endl;
+                }
+                mismatches++;
+            }
+        }
+    }
+    return mismatches;
+}
+
+/*
+ * Checks mulMod against the double-and-add product for moduli close to 2^62. Returns the number of mismatches.
+ *
+ */
+uint checkMulMod(std::mt19937 &rng) {
+    std::vector<int64_t> moduli = {3, 65537, 4294967291LL, 2305843009213693951LL, 4611686018427387847LL};
+    uint mismatches = 0;
+    for (int64_t p : moduli) {
+        std::uniform_int_distribution<int64_t> uniform(0, p - 1);
+        std::vector<int64_t> values = {0, 1, p - 1, p - 2, p / 2};
+        for (int s = 0; s < 200; s++) {
+            values.push_back(uniform(rng));
+        }
+        for (uint i = 0; i < values.size(); i++) {
+            int64_t a = values[i];
+            int64_t b = values[(i * 7 + 3) % values.size()];
+            if (mulMod(a, b, p) != referenceMulMod(a, b, p)) {
+                if (mismatches == 0) {
+                    std::cout << "mulMod(" << a << ", " << b << ", " << p << ") = " << mulMod(a, b, p) << ", expected " << referenceMulMod(a, b, p) << std::endl;
+                }
+                mismatches++;
+            }
+        }
+    }
+    return mismatches;
+}
+
+int main() {
+    std::mt19937 rng(2023);
+    uint mismatches = checkMulMod(rng);
+
+    std::vector<int> primes = {3, 17, 257, 65537};
+    std::vector<int> divisors = {1, 2, 3, 7, -5};
+    for (int p : primes) {
+        mismatches += checkTable("sign", evalSignPoints(p), p, rng);
+        mismatches += checkTable("equal", evalEqualPoints(p), p, rng);
+        for (int d : divisors) {
+            mismatches += checkTable("division/" + std::to_string(d), integerDivisionPoints(d, p), p, rng);
+        }
+        std::cout << "p = " << p << " checked" << std::endl;
+    }
+
+    if (mismatches > 0) {
+        std::cout << mismatches << " mismatches" << std::endl;
+        return 1;
+    }
+    std::cout << "All interpolation checks passed" << std::endl;
+    return 0;
+}
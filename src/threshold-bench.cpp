@@ -0,0 +1,143 @@
+/**
+ * @ Author: Julen Bernabe Rodriguez <julen.bernabe@tecnalia.com>
+ * @ Create Time: 2023-06-14 11:50:19
+ * @ Description: Copyright (c) 2023 Tecnalia Research & Innovation
+ */
+
+/*
+ * Threshold BGV benchmark: key ceremony, threshold decryption and the non-linear operations
+ */
+
+#include "scheme/bgvrns/cryptocontext-bgvrns.h"
+#include "gen-cryptocontext.h"
+
+#include <iostream>
+#include <fstream>
+#include <limits>
+#include <iterator>
+#include <random>
+#include <chrono>
+#include "../lib/lib.cpp"
+#include "../lib/counters.cpp"
+#include "../lib/task-graph.cpp"
+#include "../lib/planner.cpp"
+#include "../lib/bench.cpp"
+#include "../lib/threshold/threshold-basics.cpp"
+#include "../lib/core/core-power.cpp"
+#include "../lib/core/core-interpolation.cpp"
+#include "../lib/core/core-plan-cache.cpp"
+#include "../lib/core/core-compare.cpp"
+#include "../lib/core/core-int-division.cpp"
+
+using namespace lbcrypto;
+
+/*
+ * Encrypts one random value per slot in [from, to] under the joint public key.
+ */
+Ciphertext<DCRTPoly> encryptRandom(int64_t from, int64_t to, std::mt19937 &generator, cryptoTools cc) {
+    std::uniform_int_distribution<int64_t> distribution(from, to);
+    std::vector<int64_t> values(slotCount(cc));
+    for (uint i = 0; i < values.size(); i++) {
+        values[i] = distribution(generator);
+    }
+    return encryptVThresholdBGV(values, cc.pks[cc.lastKey], cc.cryptoContext);
+}
+
+/*
+ * Runs every selected operation for one set of parameters and adds its timings to the report.
+ */
+void benchParameters(const parameterPlan &plan, const benchConfig &config, BenchReport &report) {
+    std::vector<std::pair<std::string, double>> parameters = {
+        {"p", (double) plan.plaintextModulus}, {"ringDimension", (double) plan.ringDimension},
+        {"batchSize", (double) plan.batchSize}, {"depth", (double) plan.depth}
+    };
+
+    // The ceremony of the last run provides the keys of the operations below
+    cryptoTools cc;
+    thresholdTools tt;
+    std::vector<double> ceremonySeconds = timeRepetitions([&]() { cc = twoPartyKeyCeremony(plan, tt); },
+                                                          benchSelected(config, "keyCeremony") ? config.warmup : 0,
+                                                          benchSelected(config, "keyCeremony") ? config.repetitions : 1);
+    if (benchSelected(config, "keyCeremony")) {
+        report.add({"keyCeremony", parameters, ceremonySeconds});
+    }
+
+    // Fixed seed, so every run of the benchmark uses the same inputs
+    int p = plan.plaintextModulus;
+    std::mt19937 generator(p);
+    Ciphertext<DCRTPoly> c1 = encryptRandom(-(p - 1) / 4, (p - 1) / 4, generator, cc);
+    Ciphertext<DCRTPoly> c2 = encryptRandom(-(p - 1) / 4, (p - 1) / 4, generator, cc);
+    Ciphertext<DCRTPoly> divisor = encryptRandom(1, (p - 1) / 4, generator, cc);
+    std::vector<int64_t> values(slotCount(cc), 1);
+
+    // Each step of the threshold decryption is timed on its own, as each runs at a different player
+    std::vector<Ciphertext<DCRTPoly>> leadPartial = partialDecryptBGVLead(c1, cc.sks[0], cc.cryptoContext);
+    std::vector<Ciphertext<DCRTPoly>> partials = partialDecryptBGVMain(c1, cc.sks[1], cc.cryptoContext, leadPartial);
+
+    std::vector<std::pair<std::string, std::function<void()>>> operations = {
+        {"encrypt", [&]() { encryptVThresholdBGV(values, cc.pks[cc.lastKey], cc.cryptoContext); }},
+        {"partialDecryptLead", [&]() { partialDecryptBGVLead(c1, cc.sks[0], cc.cryptoContext); }},
+        {"partialDecryptMain", [&]() { partialDecryptBGVMain(c1, cc.sks[1], cc.cryptoContext, leadPartial); }},
+        {"decryptFusion", [&]() { decryptThresholdBGV(partials, cc.cryptoContext); }},
+        {"sign", [&]() { sign(c1, cc); }},
+        {"equal", [&]() { equal(c1, c2, cc); }},
+        {"gt", [&]() { gt(c1, c2, cc); }},
+        {"gteq", [&]() { gteq(c1, c2, cc); }},
+        {"lt", [&]() { lt(c1, c2, cc); }},
+        {"lteq", [&]() { lteq(c1, c2, cc); }},
+        {"max", [&]() { max(c1, c2, cc); }},
+        {"min", [&]() { min(c1, c2, cc); }},
+        {"compareAll", [&]() { compareAll(c1, c2, cc); }},
+        {"intPubDivision", [&]() { intPubDivision(c1, 3, cc); }},
+        {"intPrivDivision", [&]() { intPrivDivision(c1, divisor, cc); }}
+    };
+    for (uint t = 0; t < config.threads.size(); t++) {
+        for (uint s = 0; s < config.streaming.size(); s++) {
+            setEvalThreads(config.threads[t]);
+            setStreamingEvaluation(config.streaming[s] != 0);
+            std::vector<std::pair<std::string, double>> runParameters = parameters;
+            runParameters.push_back({"threads", (double) evalThreads});
+            runParameters.push_back({"streaming", (double) streamingEvaluation});
+            for (uint i = 0; i < operations.size(); i++) {
+                if (benchSelected(config, operations[i].first)) {
+                    report.add({operations[i].first, runParameters, timeRepetitions(operations[i].second, config.warmup, config.repetitions)});
+                }
+            }
+        }
+    }
+    setEvalThreads(1);
+    setStreamingEvaluation(false);
+}
+
+int main(int argc, char **argv) {
+    benchConfig config;
+    if (!parseBenchArgs(argc, argv, config)) {
+        std::cerr << "Usage: " << argv[0] << " [--p 257,...] [--ring 0,...] [--batch 0,...] [--threads 1,...] [--streaming 0,1]"
+                  << " [--warmup n] [--reps n] [--ops keyCeremony,...] [--out file.json]" << std::endl;
+        return 1;
+    }
+
+    loadPlanCache(planCachePath);
+    BenchReport report("threshold", config);
+    for (uint i = 0; i < config.moduli.size(); i++) {
+        for (uint j = 0; j < config.ringDimensions.size(); j++) {
+            for (uint k = 0; k < config.batchSizes.size(); k++) {
+                parameterPlan plan = planParameters(config.moduli[i], {PLAN_COMPARE_ALL, PLAN_PRIVATE_DIVISION}, HEStd_NotSet,
+                                                    config.batchSizes[k], GeneratePlannedThresholdBGVrnsContext);
+                if (config.ringDimensions[j] && !setPlanRingDimension(plan, config.ringDimensions[j], config.batchSizes[k])) {
+                    std::cerr << "Skipping ring dimension " << config.ringDimensions[j] << ": no packing for p = " << config.moduli[i] << std::endl;
+                    continue;
+                }
+                benchParameters(plan, config, report);
+            }
+        }
+    }
+    savePlanCache(planCachePath);
+    dumpOperationCounts(std::cerr);
+
+    if (!report.write()) {
+        std::cerr << "Cannot write " << config.output << std::endl;
+        return 1;
+    }
+    return 0;
+}
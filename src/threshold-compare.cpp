@@ -18,38 +18,39 @@
 #include <random>
 #include <time.h>
 #include "../lib/lib.cpp"
+#include "../lib/counters.cpp"
+#include "../lib/task-graph.cpp"
+#include "../lib/planner.cpp"
+#include "../lib/key-store.cpp"
+#include "../lib/wire.cpp"
 #include "../lib/threshold/threshold-basics.cpp"
-#include "../lib/threshold/threshold-power.cpp"
-#include "../lib/threshold/threshold-interpolation.cpp"
-#include "../lib/threshold/threshold-compare.cpp"
+#include "../lib/threshold/threshold-key-store.cpp"
+#include "../lib/core/core-power.cpp"
+#include "../lib/core/core-interpolation.cpp"
+#include "../lib/core/core-plan-cache.cpp"
+#include "../lib/core/core-compare.cpp"
 
 using namespace lbcrypto;
 
 void threshold_compare() {
     
 
-    cryptoTools cc = genThresholdBGVCryptoTools(257, 16);
+    parameterPlan plan = planParameters(257, {PLAN_COMPARE_ALL}, HEStd_NotSet, 0, GeneratePlannedThresholdBGVrnsContext);
+    printParameterPlan(plan);
 
-    thresholdTools tt = init(cc.sks[0], cc.cryptoContext);
+    // Every party keeps its secret key share in its own store, the rest of the setup is public
+    std::string publicPath = "threshold-compare.keys";
+    std::vector<std::string> sharePaths = {"threshold-compare.party-a.keys", "threshold-compare.party-b.keys"};
 
-    // Now thresholdTools is sent to party B
+    cryptoTools cc;
+    thresholdTools tt;
+    if (!loadThresholdTools(cc, tt, plan, publicPath, sharePaths)) {
+        cc = twoPartyKeyCeremony(plan, tt);
 
-    // party B generates her multi-party key (appended at the end of keys in cryptoTools)
-    cc = newMultiPartyKey(cc);
-
-    // then uses this multi-party key to update threshold keys
-    tt.AddedKey = updateAddedMultKey(tt.AddedKey, cc.sks[1], cc.pks[1], cc.cryptoContext);
-
-    // Now thresholdTools is sent again to party A to update MultKey
-
-    // party A initializes the final mult key version (using added mult key)
-    tt.MultKey = initFinalMultKey(tt.AddedKey, cc.sks[0], cc.pks[0], cc.cryptoContext);
-    
-    // Now thresholdTools is sent back to party B to update MultKey
-    tt.MultKey = updateFinalMultKey(tt.AddedKey, tt.MultKey, cc.sks[1], cc.pks[1], cc.cryptoContext);
-
-    // Now set final MultKey
-    cc.cryptoContext = setFinalMultKey(tt.MultKey, cc.cryptoContext);
+        if (!saveThresholdSetup(cc, tt, plan, publicPath, sharePaths)) {
+            std::cerr << "Cannot store the keys: a new key ceremony will run next time" << std::endl;
+        }
+    }
 
     std::cout << "\nTHRESHOLD BGV NON-LINEAR OPERATIONS\n "<< std::endl;
 
@@ -95,19 +96,30 @@ void threshold_compare() {
     time_t timer4;
     double seconds1;
     time(&timer3);
-    Ciphertext<DCRTPoly> cEq = equal(c3, c4, cc);
-    Ciphertext<DCRTPoly> cGreater = gt(c3, c4, cc);
-    Ciphertext<DCRTPoly> cGreaterEq = gteq(c3, c4, cc);
-    Ciphertext<DCRTPoly> cLower = lt(c3, c4, cc);
-    Ciphertext<DCRTPoly> cLowerEq = lteq(c3, c4, cc);
-    Ciphertext<DCRTPoly> cMax = max(c3, c4, cc);
-    Ciphertext<DCRTPoly> cMin = min(c3, c4, cc);
+    // The independent operations of the task graph run concurrently on every core
+    setEvalThreads(maxEvalThreads());
+    comparisonResults results = compareAll(c3, c4, cc);
+    setEvalThreads(1);
+    Ciphertext<DCRTPoly> cEq = results.eq;
+    Ciphertext<DCRTPoly> cGreater = results.gt;
+    Ciphertext<DCRTPoly> cGreaterEq = results.gteq;
+    Ciphertext<DCRTPoly> cLower = results.lt;
+    Ciphertext<DCRTPoly> cLowerEq = results.lteq;
+    Ciphertext<DCRTPoly> cMax = results.max;
+    Ciphertext<DCRTPoly> cMin = results.min;
     time(&timer4);
     seconds1 = difftime(timer4,timer3);
 
     // -----------------------------------------------------
 
-    // Here the result is sent to the client
+    // Here the result is sent to the client, switched down to the smallest modulus that decrypts
+    cEq = compactCiphertext(cEq, cc.cryptoContext);
+    cGreater = compactCiphertext(cGreater, cc.cryptoContext);
+    cGreaterEq = compactCiphertext(cGreaterEq, cc.cryptoContext);
+    cLower = compactCiphertext(cLower, cc.cryptoContext);
+    cLowerEq = compactCiphertext(cLowerEq, cc.cryptoContext);
+    cMax = compactCiphertext(cMax, cc.cryptoContext);
+    cMin = compactCiphertext(cMin, cc.cryptoContext);
 
     // -------------------- CLIENT SIDE --------------------
 
@@ -150,5 +162,10 @@ void threshold_compare() {
 }
 
 int main() {
+    loadPlanCache(planCachePath);
     threshold_compare();
+    savePlanCache(planCachePath);
+
+    std::cout << "\nOPERATION COUNTERS (per call)\n" << std::endl;
+    dumpOperationCounts(std::cout);
 }
\ No newline at end of file
@@ -18,39 +18,40 @@
 #include <random>
 #include <time.h>
 #include "../lib/lib.cpp"
+#include "../lib/counters.cpp"
+#include "../lib/task-graph.cpp"
+#include "../lib/planner.cpp"
+#include "../lib/key-store.cpp"
+#include "../lib/wire.cpp"
 #include "../lib/threshold/threshold-basics.cpp"
-#include "../lib/threshold/threshold-power.cpp"
-#include "../lib/threshold/threshold-interpolation.cpp"
-#include "../lib/threshold/threshold-compare.cpp"
-#include "../lib/threshold/threshold-int-division.cpp"
+#include "../lib/threshold/threshold-key-store.cpp"
+#include "../lib/core/core-power.cpp"
+#include "../lib/core/core-interpolation.cpp"
+#include "../lib/core/core-plan-cache.cpp"
+#include "../lib/core/core-compare.cpp"
+#include "../lib/core/core-int-division.cpp"
 
 using namespace lbcrypto;
 
 void threshold_divide() {
     
 
-    cryptoTools cc = genThresholdBGVCryptoTools(257, 16);
+    parameterPlan plan = planParameters(257, {PLAN_PUBLIC_DIVISION, PLAN_PRIVATE_DIVISION}, HEStd_NotSet, 0, GeneratePlannedThresholdBGVrnsContext);
+    printParameterPlan(plan);
 
-    thresholdTools tt = init(cc.sks[0], cc.cryptoContext);
+    // Every party keeps its secret key share in its own store, the rest of the setup is public
+    std::string publicPath = "threshold-division.keys";
+    std::vector<std::string> sharePaths = {"threshold-division.party-a.keys", "threshold-division.party-b.keys"};
 
-    // Now thresholdTools is sent to party B
+    cryptoTools cc;
+    thresholdTools tt;
+    if (!loadThresholdTools(cc, tt, plan, publicPath, sharePaths)) {
+        cc = twoPartyKeyCeremony(plan, tt);
 
-    // party B generates her multi-party key (appended at the end of keys in cryptoTools)
-    cc = newMultiPartyKey(cc);
-
-    // then uses this multi-party key to update threshold keys
-    tt.AddedKey = updateAddedMultKey(tt.AddedKey, cc.sks[1], cc.pks[1], cc.cryptoContext);
-
-    // Now thresholdTools is sent again to party A to update MultKey
-
-    // party A initializes the final mult key version (using added mult key)
-    tt.MultKey = initFinalMultKey(tt.AddedKey, cc.sks[0], cc.pks[0], cc.cryptoContext);
-    
-    // Now thresholdTools is sent back to party B to update MultKey
-    tt.MultKey = updateFinalMultKey(tt.AddedKey, tt.MultKey, cc.sks[1], cc.pks[1], cc.cryptoContext);
-
-    // Now set final MultKey
-    cc.cryptoContext = setFinalMultKey(tt.MultKey, cc.cryptoContext);
+        if (!saveThresholdSetup(cc, tt, plan, publicPath, sharePaths)) {
+            std::cerr << "Cannot store the keys: a new key ceremony will run next time" << std::endl;
+        }
+    }
 
     std::cout << "\nTHRESHOLD BGV INTEGER DIVISIONS\n "<< std::endl;
 
@@ -103,10 +104,17 @@ void threshold_divide() {
     time(&timer2);
     seconds1 = difftime(timer2,timer1);
     // Division by encrypted divisor (unknown by server)
+    // The independent operations of the task graph run concurrently on every core
+    setEvalThreads(maxEvalThreads());
     Ciphertext<DCRTPoly> cPrivQuotient = intPrivDivision(c3, c4, cc);
+    setEvalThreads(1);
     time(&timer3);
     seconds2 = difftime(timer3,timer2);
 
+    // Switch the results down to the smallest modulus that decrypts before the decryption protocol
+    cPubQuotient = compactCiphertext(cPubQuotient, cc.cryptoContext);
+    cPrivQuotient = compactCiphertext(cPrivQuotient, cc.cryptoContext);
+
     // -------------------- DECRYPTION PROTOCOL --------------------
 
     // Public division
@@ -124,5 +132,10 @@ void threshold_divide() {
 }
 
 int main() {
+    loadPlanCache(planCachePath);
     threshold_divide();
+    savePlanCache(planCachePath);
+
+    std::cout << "\nOPERATION COUNTERS (per call)\n" << std::endl;
+    dumpOperationCounts(std::cout);
 }
\ No newline at end of file